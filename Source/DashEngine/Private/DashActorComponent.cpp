@@ -24,13 +24,31 @@
 #include "DashActorComponent.h"
 #include "DashEngine.h"
 
+#include "DashTickManager.h"
+
+// CVars.
+namespace DashActorComponentCVars
+{
+	static int32 BatchedTick = 1;
+	FAutoConsoleVariableRef CVarBatchedTick(
+		TEXT("p.DashBatchedTick"),
+		BatchedTick,
+		TEXT("Whether Dash actor components are ticked in batches by the Dash tick manager; read when they begin play.\n")
+		TEXT("0: Own tick functions, 1: Batched"),
+		ECVF_Default);
+}
 
 // Sets default values for this component's properties
 UDashActorComponent::UDashActorComponent()
 {
-	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
-	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = true;
+	// Don't tick unless needed; Blueprint subclasses implementing Event Tick are set to tick by the Blueprint compiler.
+	PrimaryComponentTick.bCanEverTick = false;
+
+	bUseBatchedTick = false;
+	BatchedTickInterval = 0.0f;
+	SleepDistance = 0.0f;
+	bIsTickBatched = false;
+	bIsTickBatchPaused = false;
 
 }
 
@@ -39,9 +57,36 @@ UDashActorComponent::UDashActorComponent()
 void UDashActorComponent::BeginPlay()
 {
 	Super::BeginPlay();
-	
-	// ...
-	
+
+	// Move the tick to the batch of the class; the batches tick during physics, unordered and not while paused.
+	if (bUseBatchedTick && DashActorComponentCVars::BatchedTick != 0 && PrimaryComponentTick.bCanEverTick && PrimaryComponentTick.bStartWithTickEnabled &&
+		PrimaryComponentTick.TickGroup == TG_DuringPhysics && !PrimaryComponentTick.bTickEvenWhenPaused && PrimaryComponentTick.GetPrerequisites().Num() == 0)
+	{
+		UDashTickManager* TickManager = GetWorld()->GetSubsystem<UDashTickManager>();
+		if (TickManager != nullptr && TickManager->RegisterComponent(this))
+		{
+			Super::SetComponentTickEnabled(false);
+			bIsTickBatched = true;
+		}
+	}
+}
+
+
+// Called when the game ends or the component is destroyed
+void UDashActorComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bIsTickBatched)
+	{
+		if (UDashTickManager* TickManager = GetWorld()->GetSubsystem<UDashTickManager>())
+		{
+			TickManager->UnregisterComponent(this);
+		}
+
+		bIsTickBatched = false;
+		bIsTickBatchPaused = false;
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 
@@ -54,6 +99,19 @@ void UDashActorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FA
 }
 
 
+void UDashActorComponent::SetComponentTickEnabled(bool bEnabled)
+{
+	// The own tick function of a batched component stays disabled; pause its entry in the batch instead.
+	if (bIsTickBatched)
+	{
+		bIsTickBatchPaused = !bEnabled;
+		return;
+	}
+
+	Super::SetComponentTickEnabled(bEnabled);
+}
+
+
 //Similar to construction script
 void UDashActorComponent::PostInitProperties()
 {
@@ -0,0 +1,312 @@
+////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2019 GalaxySoftware Studio
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#include "DashActorPool.h"
+#include "DashEngine.h"
+
+#include "DashEngineSettings.h"
+#include "GameFramework/MovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "TimerManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash Actor Pool Hits"), STAT_DashActorPoolHits, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash Actor Pool Misses"), STAT_DashActorPoolMisses, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dash Actor Pool Peak Size"), STAT_DashActorPoolPeakSize, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dash Actor Pool Free Actors"), STAT_DashActorPoolFreeActors, STATGROUP_Character);
+
+// CVars.
+namespace DashActorPoolCVars
+{
+	static int32 ActorPool = 1;
+	FAutoConsoleVariableRef CVarActorPool(
+		TEXT("p.DashActorPool"),
+		ActorPool,
+		TEXT("Whether pooled actors are reused; if 0, they are spawned and destroyed.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+}
+
+
+void IDashPooledActor::OnAcquiredFromPool_Implementation()
+{
+}
+
+void IDashPooledActor::OnReleasedToPool_Implementation()
+{
+}
+
+
+void UDashActorPoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	MaxFreeActors = GetDefault<UDashEngineSettings>()->MaxPooledActorsPerClass;
+	ActorsInitializedHandle = FWorldDelegates::OnWorldInitializedActors.AddUObject(this, &UDashActorPoolSubsystem::OnActorsInitialized);
+}
+
+void UDashActorPoolSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldInitializedActors.Remove(ActorsInitializedHandle);
+	Pools.Reset();
+	PendingWarmUps.Reset();
+
+	Super::Deinitialize();
+}
+
+AActor* UDashActorPoolSubsystem::SpawnPooledActor(TSubclassOf<AActor> ActorClass, const FTransform& Transform, AActor* Owner, APawn* Instigator)
+{
+	UWorld* World = GetWorld();
+	if (ActorClass == nullptr || World == nullptr)
+	{
+		return nullptr;
+	}
+
+	FDashActorPoolClass& Pool = Pools.FindOrAdd(ActorClass);
+
+	// Released actors may have been destroyed since, e.g. with their level.
+	while (Pool.FreeActors.Num() > 0)
+	{
+		AActor* Actor = Pool.FreeActors.Pop(false);
+		DEC_DWORD_STAT(STAT_DashActorPoolFreeActors);
+
+		if (IsValid(Actor))
+		{
+			INC_DWORD_STAT(STAT_DashActorPoolHits);
+			AddActive(Pool);
+
+			ActivateActor(Actor, Transform, Owner, Instigator);
+			return Actor;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_DashActorPoolMisses);
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.Owner = Owner;
+	SpawnParameters.Instigator = Instigator;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AActor* Actor = World->SpawnActor<AActor>(ActorClass, Transform, SpawnParameters);
+	if (Actor != nullptr)
+	{
+		AddActive(Pool);
+	}
+
+	return Actor;
+}
+
+void UDashActorPoolSubsystem::ReleasePooledActor(AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	FDashActorPoolClass& Pool = Pools.FindOrAdd(Actor->GetClass());
+	if (Pool.FreeActors.Contains(Actor))
+	{
+		return;
+	}
+
+	Pool.NumActive = FMath::Max(Pool.NumActive - 1, 0);
+
+	if (DashActorPoolCVars::ActorPool == 0 || Pool.FreeActors.Num() >= MaxFreeActors)
+	{
+		Actor->Destroy();
+		return;
+	}
+
+	if (Actor->GetClass()->ImplementsInterface(UDashPooledActor::StaticClass()))
+	{
+		IDashPooledActor::Execute_OnReleasedToPool(Actor);
+	}
+
+	DeactivateActor(Actor);
+
+	Pool.FreeActors.Add(Actor);
+	INC_DWORD_STAT(STAT_DashActorPoolFreeActors);
+}
+
+void UDashActorPoolSubsystem::WarmUp(TSubclassOf<AActor> ActorClass, int32 Count)
+{
+	UWorld* World = GetWorld();
+	if (ActorClass == nullptr || World == nullptr || DashActorPoolCVars::ActorPool == 0)
+	{
+		return;
+	}
+
+	Count = FMath::Min(Count, MaxFreeActors);
+
+	// BeginPlay would enable the ticks and start the timers and life span of actors already disabled.
+	if (!World->HasBegunPlay())
+	{
+		int32& PendingCount = PendingWarmUps.FindOrAdd(ActorClass);
+		PendingCount = FMath::Max(PendingCount, Count);
+		return;
+	}
+
+	FDashActorPoolClass& Pool = Pools.FindOrAdd(ActorClass);
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	while (Pool.FreeActors.Num() < Count)
+	{
+		AActor* Actor = World->SpawnActor<AActor>(ActorClass, FTransform::Identity, SpawnParameters);
+		if (Actor == nullptr)
+		{
+			break;
+		}
+
+		DeactivateActor(Actor);
+
+		Pool.FreeActors.Add(Actor);
+		INC_DWORD_STAT(STAT_DashActorPoolFreeActors);
+	}
+}
+
+int32 UDashActorPoolSubsystem::GetNumFreeActors(TSubclassOf<AActor> ActorClass) const
+{
+	const FDashActorPoolClass* Pool = Pools.Find(ActorClass);
+	return Pool != nullptr ? Pool->FreeActors.Num() : 0;
+}
+
+void UDashActorPoolSubsystem::Tick(float DeltaTime)
+{
+	if (!GetWorld()->HasBegunPlay())
+	{
+		return;
+	}
+
+	TMap<UClass*, int32> WarmUps = MoveTemp(PendingWarmUps);
+	PendingWarmUps.Reset();
+
+	for (const TPair<UClass*, int32>& WarmUpEntry : WarmUps)
+	{
+		WarmUp(WarmUpEntry.Key, WarmUpEntry.Value);
+	}
+}
+
+bool UDashActorPoolSubsystem::IsTickable() const
+{
+	return PendingWarmUps.Num() > 0 && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+UWorld* UDashActorPoolSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UDashActorPoolSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDashActorPoolSubsystem, STATGROUP_Tickables);
+}
+
+void UDashActorPoolSubsystem::OnActorsInitialized(const UWorld::FActorsInitializedParams& Params)
+{
+	if (Params.World != GetWorld() || !Params.World->IsGameWorld())
+	{
+		return;
+	}
+
+	for (const FDashActorPoolWarmUp& Entry : GetDefault<UDashEngineSettings>()->ActorPoolWarmUp)
+	{
+		if (UClass* ActorClass = Entry.ActorClass.LoadSynchronous())
+		{
+			WarmUp(ActorClass, Entry.Count);
+		}
+	}
+}
+
+void UDashActorPoolSubsystem::DeactivateActor(AActor* Actor)
+{
+	Actor->GetWorldTimerManager().ClearAllTimersForObject(Actor);
+	Actor->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+
+	for (UActorComponent* Component : Actor->GetComponents())
+	{
+		if (Component == nullptr)
+		{
+			continue;
+		}
+
+		if (UMovementComponent* MovementComponent = Cast<UMovementComponent>(Component))
+		{
+			MovementComponent->StopMovementImmediately();
+		}
+
+		Component->SetComponentTickEnabled(false);
+	}
+}
+
+void UDashActorPoolSubsystem::ActivateActor(AActor* Actor, const FTransform& Transform, AActor* Owner, APawn* Instigator)
+{
+	Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	Actor->SetOwner(Owner);
+	Actor->SetInstigator(Instigator);
+
+	Actor->SetActorHiddenInGame(false);
+	Actor->SetActorEnableCollision(true);
+	Actor->SetActorTickEnabled(Actor->PrimaryActorTick.bStartWithTickEnabled);
+
+	// Restore the ticks of the components as they were when spawned.
+	for (UActorComponent* Component : Actor->GetComponents())
+	{
+		if (Component != nullptr)
+		{
+			Component->SetComponentTickEnabled(Component->PrimaryComponentTick.bStartWithTickEnabled);
+		}
+	}
+
+	// Deactivation cleared the life span timer with the others.
+	if (Actor->InitialLifeSpan > 0.0f)
+	{
+		Actor->SetLifeSpan(Actor->InitialLifeSpan);
+	}
+
+	if (Actor->GetClass()->ImplementsInterface(UDashPooledActor::StaticClass()))
+	{
+		IDashPooledActor::Execute_OnAcquiredFromPool(Actor);
+	}
+}
+
+void UDashActorPoolSubsystem::AddActive(FDashActorPoolClass& Pool)
+{
+	Pool.NumActive++;
+	if (Pool.NumActive > Pool.PeakSize)
+	{
+		Pool.PeakSize = Pool.NumActive;
+
+		int32 PeakSize = 0;
+		for (const TPair<UClass*, FDashActorPoolClass>& Pair : Pools)
+		{
+			PeakSize = FMath::Max(PeakSize, Pair.Value.PeakSize);
+		}
+
+		SET_DWORD_STAT(STAT_DashActorPoolPeakSize, PeakSize);
+	}
+}
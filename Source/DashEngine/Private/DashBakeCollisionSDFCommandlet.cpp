@@ -0,0 +1,189 @@
+////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2019 GalaxySoftware Studio
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#include "DashBakeCollisionSDFCommandlet.h"
+#include "DashEngine.h"
+
+#include "Engine/World.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+#include "AssetRegistryModule.h"
+#include "DashCollisionSDF.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDashBakeCollisionSDF, Log, All);
+
+
+#if WITH_EDITOR
+namespace DashBakeCollisionSDFStatics
+{
+	/**
+	* Bake and save the distance field of a map.
+	*
+	* @param Map - Short or long package name of the map.
+	* @return Whether the distance field was saved.
+	*/
+	static bool BakeMap(const FString& Map, ECollisionChannel CollisionChannel, float VoxelSize, int32 BrickSize)
+	{
+		FString MapPackageName = Map;
+		if (!FPackageName::IsValidLongPackageName(MapPackageName) && !FPackageName::SearchForPackageOnDisk(Map + FPackageName::GetMapPackageExtension(), &MapPackageName))
+		{
+			UE_LOG(LogDashBakeCollisionSDF, Error, TEXT("Can't find map %s."), *Map);
+			return false;
+		}
+
+		UPackage* MapPackage = LoadPackage(nullptr, *MapPackageName, LOAD_None);
+		UWorld* World = MapPackage != nullptr ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+		if (World == nullptr)
+		{
+			UE_LOG(LogDashBakeCollisionSDF, Error, TEXT("Can't load map %s."), *MapPackageName);
+			return false;
+		}
+
+		// Distances to collision are measured on the physics state of the components.
+		World->WorldType = EWorldType::Editor;
+		World->AddToRoot();
+		if (!World->bIsWorldInitialized)
+		{
+			World->InitWorld(UWorld::InitializationValues()
+				.ShouldSimulatePhysics(false)
+				.EnableTraceCollision(true)
+				.CreateNavigation(false)
+				.CreateAISystem(false)
+				.AllowAudioPlayback(false));
+		}
+
+		World->UpdateWorldComponents(true, false);
+
+		const FString PackageName = UDashCollisionSDFSubsystem::GetCollisionSDFPackageName(MapPackageName);
+		const FString AssetName = FPackageName::GetShortName(PackageName);
+		UPackage* Package = CreatePackage(nullptr, *PackageName);
+		Package->FullyLoad();
+
+		UDashCollisionSDF* CollisionSDF = FindObject<UDashCollisionSDF>(Package, *AssetName);
+		const bool bCreated = CollisionSDF == nullptr;
+		if (bCreated)
+		{
+			CollisionSDF = NewObject<UDashCollisionSDF>(Package, *AssetName, RF_Public | RF_Standalone);
+		}
+
+		CollisionSDF->Build(World, CollisionChannel, VoxelSize, BrickSize);
+
+		World->CleanupWorld();
+		World->RemoveFromRoot();
+
+		if (!CollisionSDF->HasData())
+		{
+			UE_LOG(LogDashBakeCollisionSDF, Error, TEXT("Nothing was baked for %s."), *MapPackageName);
+			return false;
+		}
+
+		if (bCreated)
+		{
+			FAssetRegistryModule::AssetCreated(CollisionSDF);
+		}
+
+		Package->MarkPackageDirty();
+
+		const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+		if (!UPackage::SavePackage(Package, CollisionSDF, RF_Public | RF_Standalone, *Filename))
+		{
+			UE_LOG(LogDashBakeCollisionSDF, Error, TEXT("Can't save %s."), *Filename);
+			return false;
+		}
+
+		UE_LOG(LogDashBakeCollisionSDF, Display, TEXT("Saved %s."), *Filename);
+		return true;
+	}
+}
+#endif
+
+
+UDashBakeCollisionSDFCommandlet::UDashBakeCollisionSDFCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UDashBakeCollisionSDFCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamMap;
+	ParseCommandLine(*Params, Tokens, Switches, ParamMap);
+
+	const FString* MapList = ParamMap.Find(TEXT("Map"));
+	if (MapList == nullptr)
+	{
+		UE_LOG(LogDashBakeCollisionSDF, Error, TEXT("Usage: -run=DashBakeCollisionSDF -Map=TestMap+2DTestMap [-VoxelSize=20] [-BrickSize=8] [-Channel=Pawn]"));
+		return 1;
+	}
+
+	float VoxelSize = 20.0f;
+	if (const FString* Value = ParamMap.Find(TEXT("VoxelSize")))
+	{
+		VoxelSize = FCString::Atof(**Value);
+	}
+
+	int32 BrickSize = 8;
+	if (const FString* Value = ParamMap.Find(TEXT("BrickSize")))
+	{
+		BrickSize = FCString::Atoi(**Value);
+	}
+
+	ECollisionChannel CollisionChannel = ECC_Pawn;
+	if (const FString* Value = ParamMap.Find(TEXT("Channel")))
+	{
+		const int64 Channel = StaticEnum<ECollisionChannel>()->GetValueByNameString(FString(TEXT("ECC_")) + *Value);
+		if (Channel == INDEX_NONE)
+		{
+			UE_LOG(LogDashBakeCollisionSDF, Error, TEXT("Unknown collision channel %s."), **Value);
+			return 1;
+		}
+
+		CollisionChannel = (ECollisionChannel)Channel;
+	}
+
+	TArray<FString> Maps;
+	MapList->ParseIntoArray(Maps, TEXT("+"));
+
+	int32 NumFailed = 0;
+	for (const FString& Map : Maps)
+	{
+		if (!DashBakeCollisionSDFStatics::BakeMap(Map, CollisionChannel, VoxelSize, BrickSize))
+		{
+			NumFailed++;
+		}
+
+		CollectGarbage(RF_NoFlags);
+	}
+
+	return NumFailed > 0 ? 1 : 0;
+#else
+	UE_LOG(LogDashBakeCollisionSDF, Error, TEXT("Collision SDFs can only be baked with editor data."));
+	return 1;
+#endif
+}
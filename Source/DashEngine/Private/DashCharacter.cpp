@@ -90,6 +90,13 @@ void ADashCharacter::PostNetReceiveLocationAndRotation()
 		RepMovement.Location += NewRotation.GetAxisZ() * 0.01f;
 		SetReplicatedMovement(RepMovement);
 
+		// Interpolating proxies are moved by their movement component.
+		UDashCharacterMovementComponent* DashMovement = Cast<UDashCharacterMovementComponent>(GetCharacterMovement());
+		if (DashMovement != nullptr && DashMovement->AddSimulatedSnapshot(GetReplicatedMovement().Location, NewRotation))
+		{
+			return;
+		}
+
 		SetActorLocationAndRotation(GetReplicatedMovement().Location, GetReplicatedMovement().Rotation, /*bSweep=*/ false);
 
 		INetworkPredictionInterface* PredictionInterface = Cast<INetworkPredictionInterface>(GetMovementComponent());
@@ -17,13 +17,24 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/PhysicsVolume.h"
 #include "GameFramework/GameNetworkManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
 #include "AI/Navigation/PathFollowingAgentInterface.h"
 #include "AI/Navigation/AvoidanceManager.h"
 #include "Navigation/PathFollowingComponent.h" // @todo Epic: this is here only due to circular dependency to AIModule.
 //#include "DestructibleInterface.h"
 #include "DestructibleComponent.h"
 #include "Engine/Canvas.h"
+#include "UObject/UObjectIterator.h"
 #include "Net/PerfCountersHelpers.h"
+#include "Net/UnrealNetwork.h"
+#include "DashMovementManager.h"
+#include "DashCollisionSDF.h"
+#include "DashGravityField.h"
+#include "DashRingSubsystem.h"
+#include "DashSignificanceManager.h"
+#include "Components/SplineComponent.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogCharacterMovement, Log, All);
 
@@ -33,6 +44,37 @@ DECLARE_CYCLE_STAT(TEXT("Char StepUp"), STAT_CharStepUp, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char AdjustFloorHeight"), STAT_CharAdjustFloorHeight, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char PhysWalking"), STAT_CharPhysWalking, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char PhysFalling"), STAT_CharPhysFalling, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char FixedTimeStep"), STAT_CharFixedTimeStep, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char PhysGrinding"), STAT_CharPhysGrinding, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Char Client Corrections"), STAT_CharClientCorrections, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char FixedTimeStep Steps"), STAT_CharFixedTimeStepSteps, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char FloorCache Hits"), STAT_CharFloorCacheHits, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char FloorCache Misses"), STAT_CharFloorCacheMisses, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char AsyncFloorProbe Hits"), STAT_CharAsyncFloorProbeHits, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char AsyncFloorProbe Misses"), STAT_CharAsyncFloorProbeMisses, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Substeps Walking"), STAT_CharSubstepsWalking, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Substeps Falling"), STAT_CharSubstepsFalling, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Simulated LOD Full Ticks"), STAT_CharSimulatedLODFull, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Simulated LOD Extrapolate Ticks"), STAT_CharSimulatedLODExtrapolate, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Simulated LOD Interpolate Ticks"), STAT_CharSimulatedLODInterpolate, STATGROUP_Character);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Char Simulated LOD Saved (ms)"), STAT_CharSimulatedLODSaved, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Queries"), STAT_CharQueries, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Frame State Queries"), STAT_CharFrameStateQueries, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Queries FloorSweep"), STAT_CharQueriesFloorSweep, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Queries FloorLineTrace"), STAT_CharQueriesFloorLineTrace, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Queries StepUp"), STAT_CharQueriesStepUp, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Queries Move"), STAT_CharQueriesMove, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Queries CheckLedgeDirection"), STAT_CharQueriesCheckLedgeDirection, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Queries CheckWaterJump"), STAT_CharQueriesCheckWaterJump, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Queries ImmersionDepth"), STAT_CharQueriesImmersionDepth, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Queries RepulsionForce"), STAT_CharQueriesRepulsionForce, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Queries Crouch"), STAT_CharQueriesCrouch, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Queries AsyncFloorProbe"), STAT_CharQueriesAsyncFloorProbe, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Queries GrindProbe"), STAT_CharQueriesGrindProbe, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Queries CollisionSDF"), STAT_CharQueriesCollisionSDF, STATGROUP_Character);
+
+// CSV profiler stats, captured by the movement benchmark.
+CSV_DEFINE_CATEGORY(DashMovement, true);
 
 // Magic numbers.
 const float MAX_STEP_SIDE_Z = 0.08f; // Maximum Z value for the normal on the vertical side of steps.
@@ -46,8 +88,45 @@ namespace DashCharacterMovementComponentStatics
 	static const FName CheckLedgeDirectionName = FName(TEXT("CheckLedgeDirection"));
 	static const FName CheckWaterJumpName = FName(TEXT("CheckWaterJump"));
 	static const FName ComputeFloorDistName = FName(TEXT("ComputeFloorDistSweep"));
+	static const FName AsyncFloorProbeName = FName(TEXT("AsyncFloorProbe"));
+	static const FName GrindProbeName = FName(TEXT("GrindProbe"));
 	static const FName FloorLineTraceName = FName(TEXT("ComputeFloorDistLineTrace"));
 	static const FName ImmersionDepthName = FName(TEXT("MovementComp_Character_ImmersionDepth"));
+	static const FName StepUpName = FName(TEXT("StepUp"));
+	static const FName MoveName = FName(TEXT("MoveUpdatedComponent"));
+	static const FName RepulsionForceName = FName(TEXT("ApplyRepulsionForce"));
+	static const FName CollisionSDFName = FName(TEXT("CollisionSDF"));
+
+	// Names of the collision query call sites, used by the CSV profiler and the debug display.
+	static const FName CollisionQueryNames[] =
+	{
+		ComputeFloorDistName,
+		FloorLineTraceName,
+		StepUpName,
+		MoveName,
+		CheckLedgeDirectionName,
+		CheckWaterJumpName,
+		ImmersionDepthName,
+		RepulsionForceName,
+		CrouchTraceName,
+		AsyncFloorProbeName,
+		GrindProbeName,
+		CollisionSDFName
+	};
+
+	static_assert(UE_ARRAY_COUNT(CollisionQueryNames) == (int32)EDashCollisionQuery::MAX, "Collision query names must match EDashCollisionQuery.");
+
+	// Replicated snapshots kept by simulated proxies.
+	static const int32 MaxSimulatedSnapshots = 8;
+
+	// Simulated proxies go back to a higher detail level at this fraction of the distance they left it.
+	static const float SimulatedLODHysteresis = 0.9f;
+
+	// Running average cost of a full simulated proxy tick, in milliseconds; the baseline of the saved time estimate.
+	static float SimulatedFullTickCost = 0.0f;
+
+	// The path lock searches the whole path again when its closest point is this many samples away along the path.
+	static const float PathLockReacquireSamples = 3.0f;
 }
 
 // CVars.
@@ -70,6 +149,39 @@ namespace DashCharacterMovementCVars
 		TEXT("Time in seconds each visualized network correction persists."),
 		ECVF_Cheat);
 #endif // !UE_BUILD_SHIPPING
+
+	static int32 NetSaveGravityInMoves = 1;
+	FAutoConsoleVariableRef CVarNetSaveGravityInMoves(
+		TEXT("p.NetSaveGravityInMoves"),
+		NetSaveGravityInMoves,
+		TEXT("Whether Dash saved moves record and replay gravity state; compare correction counts with it disabled.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+
+	static int32 CollisionQueryBudget = 0;
+	FAutoConsoleVariableRef CVarCollisionQueryBudget(
+		TEXT("p.DashCollisionQueryBudget"),
+		CollisionQueryBudget,
+		TEXT("Collision queries one tick of a Dash character may issue before a warning is logged, for characters without their own budget.\n")
+		TEXT("0: Disable"),
+		ECVF_Default);
+
+	static int32 FrameStateCache = 1;
+	FAutoConsoleVariableRef CVarFrameStateCache(
+		TEXT("p.DashFrameStateCache"),
+		FrameStateCache,
+		TEXT("Whether Dash character movement components cache gravity and component axes during a substep.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+
+	FAutoConsoleCommandWithWorldAndArgs CmdMicroBenchmark(
+		TEXT("p.DashMicroBenchmark"),
+		TEXT("Time the hot queries of every Dash character movement component and log their cost.\n")
+		TEXT("Optional argument: amount of iterations (default 100000)."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UDashCharacterMovementComponent::RunMicroBenchmark(World, Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100000);
+		}));
 }
 
 
@@ -79,14 +191,103 @@ UDashCharacterMovementComponent::UDashCharacterMovementComponent(const FObjectIn
 	bAlignComponentToFloor = false;
 	bAlignComponentToGravity = false;
 	bAlignCustomGravityToFloor = false;
-	bDirtyCustomGravityDirection = false;
 	bDisableGravityReplication = false;
 	bIgnoreBaseRollMove = false;
 	CustomGravityDirection = FVector::ZeroVector;
 	GravityPoint = FVector::ZeroVector;
-	OldGravityPoint = GravityPoint;
-	OldGravityScale = GravityScale;
-	
+	ReplicatedGravity.Scale = GravityScale;
+	GravityReplicationAngleThreshold = 2.0f;
+	GravityReplicationPointThreshold = 10.0f;
+
+	bUseFixedTimeStep = false;
+	FixedTimeStepRate = 120.0f;
+	MaxFixedTimeSteps = 4;
+	FixedTimeStepAccumulator = 0.0f;
+	FixedTimeStepPreviousLocation = FVector::ZeroVector;
+	FixedTimeStepPreviousRotation = FQuat::Identity;
+	bFixedTimeStepActive = false;
+
+	bEnableFloorCache = false;
+	FloorCacheMaxMoveDistance = 1.0f;
+
+	bUseAsyncFloorProbe = false;
+	AsyncFloorProbeTolerance = 10.0f;
+	AsyncFloorProbeFrame = 0;
+	AsyncFloorProbeShrinkHeight = 0.0f;
+
+	bUseMovementPrepass = false;
+
+	GrindSampleDistance = 25.0f;
+	GrindHeightOffset = 0.0f;
+	GrindBrakingDeceleration = 0.0f;
+	GrindMinSpeed = 200.0f;
+	bAlignComponentToGrindSpline = true;
+	GrindSpline = nullptr;
+	GrindDistance = 0.0f;
+	GrindSpeed = 0.0f;
+
+	PathLockSpline = nullptr;
+	PathLockDistance = 0.0f;
+	PathLockLastLocation = FVector::ZeroVector;
+	PendingPathLockCorrection = FVector::ZeroVector;
+	bPathLockSavedConstrainToPlane = false;
+	PathLockSavedPlaneNormal = FVector::ZeroVector;
+	PathLockSavedAxisSetting = EPlaneConstraintAxisSetting::Custom;
+
+	NumClientCorrections = 0;
+
+	MaxCollisionQueriesPerTick = 0;
+	FMemory::Memzero(CollisionQueryCounts);
+	FMemory::Memzero(LastCollisionQueryCounts);
+	MoveQuery = EDashCollisionQuery::Move;
+	LastCollisionQueryWarningTime = -1.0f;
+
+	bUseCollisionSDF = false;
+	CollisionSDFSubsystem = nullptr;
+
+	bUseGravityField = true;
+	GravityField = nullptr;
+
+	bUseAdaptiveSubstepping = false;
+	AdaptiveMaxTimeStep = 0.05f;
+	AdaptiveMaxStepRadiusRatio = 1.0f;
+	AdaptiveMaxFloorAngle = 10.0f;
+	AdaptiveCurvature = 0.0f;
+	AdaptiveLastFloorNormal = FVector::ZeroVector;
+	AdaptiveLastLocation = FVector::ZeroVector;
+	NumSubsteps = 0;
+	LastNumSubsteps = 0;
+
+	bEnableSimulatedMovementLOD = false;
+	bUseSignificanceForSimulatedLOD = false;
+	SimulatedLODExtrapolateDistance = 3000.0f;
+	SimulatedLODInterpolateDistance = 8000.0f;
+	SimulatedLODOffscreenTime = 0.5f;
+	SimulatedLODExtrapolateTickInterval = 0.033f;
+	SimulatedLODInterpolateTickInterval = 0.066f;
+	SimulatedLODMaxExtrapolationTime = 0.5f;
+	SimulatedLODInterpolationDelay = 0.1f;
+	SimulatedLOD = EDashSimulatedMovementLOD::Full;
+	SimulatedLODTimeSinceUpdate = 0.0f;
+	SimulatedLODBaseTickInterval = 0.0f;
+	SimulatedLODSavedTime = 0.0f;
+	SignificanceManager = nullptr;
+
+	NumFrameStateQueries = 0;
+	LastNumFrameStateQueries = 0;
+
+	bDeferRotationUpdates = false;
+	DeferredAxisZ = FVector::ZeroVector;
+	DeferredRotation = FQuat::Identity;
+	bHasDeferredAxisZ = false;
+	bHasDeferredRotation = false;
+
+	bCollectRings = true;
+	RingSubsystem = nullptr;
+
+	bUseCurvedExtrapolation = false;
+	PathReplicationTurnRateThreshold = 5.0f;
+	PathReplicationAngleThreshold = 2.0f;
 }
 
 bool UDashCharacterMovementComponent::DoJump(bool bReplayingMoves)
@@ -211,6 +412,15 @@ void UDashCharacterMovementComponent::OnMovementModeChanged(EMovementMode Previo
 		return;
 	}
 
+	// Cached floor belongs to the previous movement mode.
+	InvalidateFloorCache();
+
+	// Leaving the rail, by jump or otherwise; the table is kept in case the character lands on the same rail again.
+	if (PreviousMovementMode == MOVE_Custom && PreviousCustomMode == CMOVE_Grinding && !IsGrinding())
+	{
+		GrindSpline = nullptr;
+	}
+
 	// Update collision settings if needed.
 	if (MovementMode == MOVE_NavWalking)
 	{
@@ -380,6 +590,13 @@ void UDashCharacterMovementComponent::SimulateMovement(float DeltaSeconds)
 		return;
 	}
 
+	// Distant proxies skip sweeps and floor checks.
+	if (bIsSimulatedProxy && SimulatedLOD != EDashSimulatedMovementLOD::Full)
+	{
+		SimulateMovementLOD(DeltaSeconds);
+		return;
+	}
+
 	FVector OldVelocity;
 	FVector OldLocation;
 
@@ -424,7 +641,25 @@ void UDashCharacterMovementComponent::SimulateMovement(float DeltaSeconds)
 		OldVelocity = Velocity;
 		OldLocation = UpdatedComponent->GetComponentLocation();
 		FStepDownResult StepDownResult;
-		MoveSmooth(Velocity, DeltaSeconds, &StepDownResult);
+
+		if (bIsSimulatedProxy && bUseCurvedExtrapolation && DeltaSeconds > 0.0f && MovementMode != MOVE_Custom)
+		{
+			// Move along the chord of the predicted arc and turn the velocity with it; gravity is applied to the velocity below.
+			FVector PredictedVelocity;
+			FQuat RotationDelta;
+			const FVector Delta = PredictPath(Velocity, DeltaSeconds, PredictedVelocity, RotationDelta);
+
+			MoveSmooth(Delta / DeltaSeconds, DeltaSeconds, &StepDownResult);
+
+			if (MovementMode != MOVE_Falling)
+			{
+				Velocity = PredictedVelocity;
+			}
+		}
+		else
+		{
+			MoveSmooth(Velocity, DeltaSeconds, &StepDownResult);
+		}
 
 		// Consume path following requested velocity.
 		bHasRequestedVelocity = false;
@@ -578,8 +813,7 @@ void UDashCharacterMovementComponent::UpdateBasedMovement(float DeltaSeconds)
 					// Nothing changed. This means we probably are using another rotation mechanism (bOrientToMovement etc). We should still follow the base object.
 					if (bOrientRotationToMovement || (bUseControllerDesiredRotation && CharacterOwner->Controller))
 					{
-						TargetRotator = ConstrainComponentRotation(TargetRotator);
-						MoveUpdatedComponent(FVector::ZeroVector, TargetRotator, false);
+						MoveUpdatedComponent(FVector::ZeroVector, ConstrainComponentQuat(TargetQuat), false);
 						FinalQuat = UpdatedComponent->GetComponentQuat();
 					}
 				}
@@ -713,6 +947,7 @@ void UDashCharacterMovementComponent::Crouch(bool bClientSimulation)
 			FCollisionQueryParams CapsuleParams(DashCharacterMovementComponentStatics::CrouchTraceName, false, CharacterOwner);
 			FCollisionResponseParams ResponseParam;
 			InitCollisionParams(CapsuleParams, ResponseParam);
+			CountCollisionQuery(EDashCollisionQuery::Crouch);
 			const bool bEncroached = GetWorld()->OverlapBlockingTestByChannel(UpdatedComponent->GetComponentLocation() + CapsuleDown * ScaledHalfHeightAdjust,
 				UpdatedComponent->GetComponentQuat(), UpdatedComponent->GetCollisionObjectType(), GetPawnCapsuleCollisionShape(SHRINK_None), CapsuleParams, ResponseParam);
 
@@ -810,6 +1045,7 @@ void UDashCharacterMovementComponent::UnCrouch(bool bClientSimulation)
 		if (!bCrouchMaintainsBaseLocation)
 		{
 			// Expand in place
+			CountCollisionQuery(EDashCollisionQuery::Crouch);
 			bEncroached = GetWorld()->OverlapBlockingTestByChannel(PawnLocation, PawnRotation, CollisionChannel, StandingCapsuleShape, CapsuleParams, ResponseParam);
 
 			if (bEncroached)
@@ -825,6 +1061,7 @@ void UDashCharacterMovementComponent::UnCrouch(bool bClientSimulation)
 
 					FHitResult Hit(1.0f);
 					const FCollisionShape ShortCapsuleShape = GetPawnCapsuleCollisionShape(SHRINK_HeightCustom, ShrinkHalfHeight);
+					CountCollisionQuery(EDashCollisionQuery::Crouch);
 					const bool bBlockingHit = GetWorld()->SweepSingleByChannel(Hit, PawnLocation, PawnLocation + CapsuleDown * TraceDist, PawnRotation, CollisionChannel, ShortCapsuleShape, CapsuleParams);
 					if (Hit.bStartPenetrating)
 					{
@@ -835,6 +1072,7 @@ void UDashCharacterMovementComponent::UnCrouch(bool bClientSimulation)
 						// Compute where the base of the sweep ended up, and see if we can stand there.
 						const float DistanceToBase = (Hit.Time * TraceDist) + ShortCapsuleShape.Capsule.HalfHeight;
 						const FVector NewLoc = PawnLocation - CapsuleDown * (-DistanceToBase + PawnHalfHeight + SweepInflation + MIN_FLOOR_DIST / 2.0f);
+						CountCollisionQuery(EDashCollisionQuery::Crouch);
 						bEncroached = GetWorld()->OverlapBlockingTestByChannel(NewLoc, PawnRotation, CollisionChannel, StandingCapsuleShape, CapsuleParams, ResponseParam);
 						if (!bEncroached)
 						{
@@ -849,6 +1087,7 @@ void UDashCharacterMovementComponent::UnCrouch(bool bClientSimulation)
 		{
 			// Expand while keeping base location the same.
 			FVector StandingLocation = PawnLocation - CapsuleDown * (StandingCapsuleShape.GetCapsuleHalfHeight() - CurrentCrouchedHalfHeight);
+			CountCollisionQuery(EDashCollisionQuery::Crouch);
 			bEncroached = GetWorld()->OverlapBlockingTestByChannel(StandingLocation, PawnRotation, CollisionChannel, StandingCapsuleShape, CapsuleParams, ResponseParam);
 
 			if (bEncroached)
@@ -860,6 +1099,7 @@ void UDashCharacterMovementComponent::UnCrouch(bool bClientSimulation)
 					if (CurrentFloor.bBlockingHit && CurrentFloor.FloorDist > MinFloorDist)
 					{
 						StandingLocation += CapsuleDown * (CurrentFloor.FloorDist - MinFloorDist);
+						CountCollisionQuery(EDashCollisionQuery::Crouch);
 						bEncroached = GetWorld()->OverlapBlockingTestByChannel(StandingLocation, PawnRotation, CollisionChannel, StandingCapsuleShape, CapsuleParams, ResponseParam);
 					}
 				}
@@ -1050,6 +1290,7 @@ float UDashCharacterMovementComponent::ImmersionDepth() const
 				const FVector TraceEnd = UpdatedComponent->GetComponentLocation() - CapsuleHalfHeight;
 
 				FCollisionQueryParams NewTraceParams(DashCharacterMovementComponentStatics::ImmersionDepthName, true);
+				CountCollisionQuery(EDashCollisionQuery::ImmersionDepth);
 				VolumeBrushComp->LineTraceComponent(Hit, TraceStart, TraceEnd, NewTraceParams);
 			}
 
@@ -1461,6 +1702,7 @@ float UDashCharacterMovementComponent::BoostAirControlEx(float DeltaTime, float
 void UDashCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
 {
 	SCOPE_CYCLE_COUNTER(STAT_CharPhysFalling);
+	CSV_SCOPED_TIMING_STAT(DashMovement, PhysFalling);
 
 	if (deltaTime < MIN_TICK_TIME)
 	{
@@ -1483,9 +1725,19 @@ void UDashCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterati
 	while (RemainingTime >= MIN_TICK_TIME && Iterations < MaxSimulationIterations)
 	{
 		Iterations++;
-		const float timeTick = GetSimulationTimeStep(RemainingTime, Iterations);
+		INC_DWORD_STAT(STAT_CharSubstepsFalling);
+		CSV_CUSTOM_STAT(DashMovement, FallingSubsteps, 1, ECsvCustomStatOp::Accumulate);
+		UpdateAdaptiveSubstep();
+		const float timeTick = GetAdaptiveSimulationTimeStep(RemainingTime, Iterations);
 		RemainingTime -= timeTick;
 
+		// Follow the locked path.
+		if (IsPathLocked())
+		{
+			UpdatePathLock();
+			FallAcceleration = FVector::VectorPlaneProject(FallAcceleration, PlaneConstraintNormal);
+		}
+
 		const FVector OldLocation = UpdatedComponent->GetComponentLocation();
 		const FQuat PawnRotation = UpdatedComponent->GetComponentQuat();
 		bJustTeleported = false;
@@ -1782,12 +2034,14 @@ bool UDashCharacterMovementComponent::CheckLedgeDirection(const FVector& OldLoca
 	const FCollisionShape CapsuleShape = GetPawnCapsuleCollisionShape(SHRINK_None);
 	const ECollisionChannel CollisionChannel = UpdatedComponent->GetCollisionObjectType();
 	FHitResult Result(1.0f);
+	CountCollisionQuery(EDashCollisionQuery::CheckLedgeDirection);
 	GetWorld()->SweepSingleByChannel(Result, OldLocation, SideDest, PawnRotation, CollisionChannel, CapsuleShape, CapsuleParams, ResponseParam);
 
 	if (!Result.bBlockingHit || IsWalkable(Result))
 	{
 		if (!Result.bBlockingHit)
 		{
+			CountCollisionQuery(EDashCollisionQuery::CheckLedgeDirection);
 			GetWorld()->SweepSingleByChannel(Result, SideDest, SideDest + GravDir * (MaxStepHeight + LedgeCheckThreshold), PawnRotation, CollisionChannel, CapsuleShape, CapsuleParams, ResponseParam);
 		}
 
@@ -1974,6 +2228,7 @@ void UDashCharacterMovementComponent::MaintainHorizontalGroundVelocity()
 void UDashCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iterations)
 {
 	SCOPE_CYCLE_COUNTER(STAT_CharPhysWalking);
+	CSV_SCOPED_TIMING_STAT(DashMovement, PhysWalking);
 
 	if (deltaTime < MIN_TICK_TIME)
 	{
@@ -2005,9 +2260,18 @@ void UDashCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iterati
 	{
 		Iterations++;
 		bJustTeleported = false;
-		const float timeTick = GetSimulationTimeStep(remainingTime, Iterations);
+		INC_DWORD_STAT(STAT_CharSubstepsWalking);
+		CSV_CUSTOM_STAT(DashMovement, WalkingSubsteps, 1, ECsvCustomStatOp::Accumulate);
+		UpdateAdaptiveSubstep();
+		const float timeTick = GetAdaptiveSimulationTimeStep(remainingTime, Iterations);
 		remainingTime -= timeTick;
 
+		// Follow the locked path.
+		if (IsPathLocked())
+		{
+			UpdatePathLock();
+		}
+
 		// Save current values.
 		UPrimitiveComponent* const OldBase = GetMovementBase();
 		const FVector PreviousBaseLocation = (OldBase != NULL) ? OldBase->GetComponentLocation() : FVector::ZeroVector;
@@ -2201,6 +2465,7 @@ void UDashCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iterati
 void UDashCharacterMovementComponent::AdjustFloorHeight()
 {
 	SCOPE_CYCLE_COUNTER(STAT_CharAdjustFloorHeight);
+	CSV_SCOPED_TIMING_STAT(DashMovement, AdjustFloorHeight);
 
 	// If we have a floor check that hasn't hit anything, don't adjust height.
 	if (!CurrentFloor.bBlockingHit)
@@ -2290,6 +2555,27 @@ void UDashCharacterMovementComponent::OnTeleported()
 	bool bWasFalling = (MovementMode == MOVE_Falling);
 	bJustTeleported = true;
 
+	InvalidateFloorCache();
+	AdaptiveLastFloorNormal = FVector::ZeroVector;
+	AdaptiveCurvature = 0.0f;
+
+	// The path lock only searches near its last distance; find the path again from the new location.
+	if (IsPathLocked())
+	{
+		PathLockDistance = PathLockArcTable.FindDistanceClosestToWorldLocation(UpdatedComponent->GetComponentLocation());
+		PathLockLastLocation = UpdatedComponent->GetComponentLocation();
+		PendingPathLockCorrection = FVector::ZeroVector;
+		SetPlaneConstraintNormal(PathLockArcTable.GetRightVectorAtDistance(PathLockDistance));
+	}
+
+	// Don't interpolate the mesh across the teleport.
+	if (bFixedTimeStepActive)
+	{
+		FixedTimeStepPreviousLocation = UpdatedComponent->GetComponentLocation();
+		FixedTimeStepPreviousRotation = UpdatedComponent->GetComponentQuat();
+		InterpolateFixedTimeStepMesh(1.0f);
+	}
+
 	// Find floor at current location.
 	UpdateFloorFromAdjustment();
 
@@ -2332,20 +2618,21 @@ void UDashCharacterMovementComponent::PhysicsRotation(float DeltaTime)
 		return;
 	}
 
-	FRotator CurrentRotation = UpdatedComponent->GetComponentRotation(); // Normalized.
-	CurrentRotation.DiagnosticCheckNaN(TEXT("CharacterMovementComponent::PhysicsRotation(): CurrentRotation"));
+	// Rotation stays in quaternions; Euler angles can't represent the capsule upside down on loops without gimbal flips.
+	const FQuat CurrentQuat = UpdatedComponent->GetComponentQuat();
+	CurrentQuat.DiagnosticCheckNaN(TEXT("CharacterMovementComponent::PhysicsRotation(): CurrentQuat"));
 
-	FRotator DeltaRot = GetDeltaRotation(DeltaTime);
+	const FRotator DeltaRot = GetDeltaRotation(DeltaTime);
 	DeltaRot.DiagnosticCheckNaN(TEXT("CharacterMovementComponent::PhysicsRotation(): GetDeltaRotation"));
 
-	FRotator DesiredRotation = CurrentRotation;
+	FQuat DesiredQuat = CurrentQuat;
 	if (bOrientRotationToMovement)
 	{
-		DesiredRotation = ComputeOrientToMovementRotation(CurrentRotation, DeltaTime, DeltaRot);
+		DesiredQuat = ComputeOrientToMovementQuat(CurrentQuat);
 	}
 	else if (CharacterOwner->Controller && bUseControllerDesiredRotation)
 	{
-		DesiredRotation = CharacterOwner->Controller->GetDesiredRotation();
+		DesiredQuat = CharacterOwner->Controller->GetDesiredRotation().Quaternion();
 	}
 	else
 	{
@@ -2353,59 +2640,79 @@ void UDashCharacterMovementComponent::PhysicsRotation(float DeltaTime)
 	}
 
 	// Always remain vertical when walking or falling.
-	if (IsMovingOnGround() || IsFalling())
+	const bool bConstrained = IsMovingOnGround() || IsFalling();
+	if (bConstrained)
 	{
-		DesiredRotation = ConstrainComponentRotation(DesiredRotation);
+		DesiredQuat = ConstrainComponentQuat(DesiredQuat);
 	}
-	else
+
+	// Accumulate a desired new rotation; a component tolerance of 1e-5 is about 1e-3 degrees and absorbs the float noise
+	// of rebuilding the rotation from axes, which AngularDistance amplifies through its acos.
+	if (CurrentQuat.Equals(DesiredQuat, 1e-5f))
 	{
-		DesiredRotation.Normalize();
+		return;
 	}
 
-	// Accumulate a desired new rotation.
-	const float AngleTolerance = 1e-3f;
+	const float Angle = CurrentQuat.AngularDistance(DesiredQuat);
 
-	if (!CurrentRotation.Equals(DesiredRotation, AngleTolerance))
+	FQuat NewQuat = DesiredQuat;
+	if (bConstrained || (DeltaRot.Roll == DeltaRot.Yaw && DeltaRot.Yaw == DeltaRot.Pitch))
 	{
-		if (DeltaRot.Roll == DeltaRot.Yaw && DeltaRot.Yaw == DeltaRot.Pitch)
+		// Constrained rotations only turn around the capsule up axis, at the yaw rate.
+		const float Alpha = FMath::Min(FMath::DegreesToRadians(DeltaRot.Yaw) / Angle, 1.0f);
+		if (Alpha < 1.0f)
 		{
-			// Calculate the spherical interpolation between the two rotators.
-			const FQuat CurrentQuat(CurrentRotation);
-			const FQuat DesiredQuat(DesiredRotation);
+			NewQuat = FQuat::Slerp(CurrentQuat, DesiredQuat, Alpha);
+		}
+	}
+	else
+	{
+		// Per axis rates of free rotations (flying, swimming) are defined in Euler angles.
+		const FRotator CurrentRotation = CurrentQuat.Rotator();
+		FRotator DesiredRotation = DesiredQuat.Rotator();
 
-			// Get shortest angle between quaternions.
-			const float Angle = FMath::Acos(FMath::Abs(CurrentQuat | DesiredQuat)) * 2.0f;
+		DesiredRotation.Pitch = FMath::FixedTurn(CurrentRotation.Pitch, DesiredRotation.Pitch, DeltaRot.Pitch);
+		DesiredRotation.Yaw = FMath::FixedTurn(CurrentRotation.Yaw, DesiredRotation.Yaw, DeltaRot.Yaw);
+		DesiredRotation.Roll = FMath::FixedTurn(CurrentRotation.Roll, DesiredRotation.Roll, DeltaRot.Roll);
 
-			// Calculate percent of interpolation.
-			const float Alpha = FMath::Min(FMath::DegreesToRadians(DeltaRot.Yaw) / Angle, 1.0f);
+		NewQuat = DesiredRotation.Quaternion();
+	}
 
-			DesiredRotation = (Alpha == 1.0f) ? DesiredRotation : FQuat::Slerp(CurrentQuat, DesiredQuat, Alpha).Rotator();
-		}
-		else
-		{
-			// Pitch.
-			if (!FMath::IsNearlyEqual(CurrentRotation.Pitch, DesiredRotation.Pitch, AngleTolerance))
-			{
-				DesiredRotation.Pitch = FMath::FixedTurn(CurrentRotation.Pitch, DesiredRotation.Pitch, DeltaRot.Pitch);
-			}
+	// Set the new rotation.
+	NewQuat.DiagnosticCheckNaN(TEXT("CharacterMovementComponent::PhysicsRotation(): NewQuat"));
 
-			// Yaw.
-			if (!FMath::IsNearlyEqual(CurrentRotation.Yaw, DesiredRotation.Yaw, AngleTolerance))
-			{
-				DesiredRotation.Yaw = FMath::FixedTurn(CurrentRotation.Yaw, DesiredRotation.Yaw, DeltaRot.Yaw);
-			}
+	if (bDeferRotationUpdates)
+	{
+		DeferredRotation = NewQuat;
+		bHasDeferredRotation = true;
+		return;
+	}
 
-			// Roll.
-			if (!FMath::IsNearlyEqual(CurrentRotation.Roll, DesiredRotation.Roll, AngleTolerance))
-			{
-				DesiredRotation.Roll = FMath::FixedTurn(CurrentRotation.Roll, DesiredRotation.Roll, DeltaRot.Roll);
-			}
+	MoveUpdatedComponent(FVector::ZeroVector, NewQuat, true);
+}
+
+FQuat UDashCharacterMovementComponent::ComputeOrientToMovementQuat(const FQuat& CurrentQuat) const
+{
+	FVector Direction = Acceleration;
+	if (Direction.SizeSquared() < KINDA_SMALL_NUMBER)
+	{
+		// AI path following request can orient us in that direction (it's effectively an acceleration).
+		if (!bHasRequestedVelocity || RequestedVelocity.SizeSquared() < KINDA_SMALL_NUMBER)
+		{
+			// Don't change rotation if there is no acceleration.
+			return CurrentQuat;
 		}
 
-		// Set the new rotation.
-		DesiredRotation.DiagnosticCheckNaN(TEXT("CharacterMovementComponent::PhysicsRotation(): DesiredRotation"));
-		MoveUpdatedComponent(FVector::ZeroVector, DesiredRotation, true);
+		Direction = RequestedVelocity;
 	}
+
+	// Rotate toward direction of acceleration; constrained afterwards when walking or falling.
+	return FRotationMatrix::MakeFromX(Direction).ToQuat();
+}
+
+FRotator UDashCharacterMovementComponent::ComputeOrientToMovementRotation(const FRotator& CurrentRotation, float DeltaTime, FRotator& DeltaRotation) const
+{
+	return ComputeOrientToMovementQuat(CurrentRotation.Quaternion()).Rotator();
 }
 
 void UDashCharacterMovementComponent::PhysicsVolumeChanged(class APhysicsVolume* NewVolume)
@@ -2502,6 +2809,7 @@ bool UDashCharacterMovementComponent::CheckWaterJumpEx(FVector CheckPoint, const
 	InitCollisionParams(CapsuleParams, ResponseParam);
 
 	FHitResult HitInfo(1.0f);
+	CountCollisionQuery(EDashCollisionQuery::CheckWaterJump);
 	bool bHit = GetWorld()->SweepSingleByChannel(HitInfo, UpdatedComponent->GetComponentLocation(), CheckPoint, UpdatedComponent->GetComponentQuat(), CollisionChannel, CapsuleShape, CapsuleParams, ResponseParam);
 
 	if (bHit && !Cast<APawn>(HitInfo.GetActor()))
@@ -2516,6 +2824,7 @@ bool UDashCharacterMovementComponent::CheckWaterJumpEx(FVector CheckPoint, const
 		InitCollisionParams(LineParams, LineResponseParam);
 
 		HitInfo.Reset(1.0f, false);
+		CountCollisionQuery(EDashCollisionQuery::CheckWaterJump);
 		bHit = GetWorld()->LineTraceSingleByChannel(HitInfo, Start, CheckPoint, CollisionChannel, LineParams, LineResponseParam);
 
 		// If no high obstruction, or it's a valid floor, then pawn can jump out of water.
@@ -2678,6 +2987,39 @@ void UDashCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLoc
 		return;
 	}
 
+	if (!bSkipSweep)
+	{
+		// Try to reuse the last sweep if the capsule barely moved on the same floor.
+		if (bEnableFloorCache && ComputeCachedFloorDist(FloorCache, FloorCacheMaxMoveDistance, CapsuleLocation, SweepDistance, SweepRadius, OutFloorResult))
+		{
+			INC_DWORD_STAT(STAT_CharFloorCacheHits);
+			return;
+		}
+
+		// Try to use the sweep done at the predicted location, last frame or during the movement prepass.
+		if (CollectAsyncFloorProbe())
+		{
+			if (ComputeCachedFloorDist(AsyncFloorProbe, AsyncFloorProbeTolerance, CapsuleLocation, SweepDistance, SweepRadius, OutFloorResult))
+			{
+				INC_DWORD_STAT(STAT_CharAsyncFloorProbeHits);
+
+				if (bEnableFloorCache)
+				{
+					UpdateFloorCache(FloorCache, CapsuleLocation, CapsuleDown * -1.0f, SweepDistance, SweepRadius, OutFloorResult);
+				}
+
+				return;
+			}
+
+			INC_DWORD_STAT(STAT_CharAsyncFloorProbeMisses);
+		}
+
+		if (bEnableFloorCache)
+		{
+			INC_DWORD_STAT(STAT_CharFloorCacheMisses);
+		}
+	}
+
 	bool bBlockingHit = false;
 	FCollisionQueryParams QueryParams(NAME_None, false, CharacterOwner);
 	FCollisionResponseParams ResponseParam;
@@ -2697,7 +3039,7 @@ void UDashCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLoc
 		FCollisionShape CapsuleShape = FCollisionShape::MakeCapsule(SweepRadius, PawnHalfHeight - ShrinkHeight);
 
 		FHitResult Hit(1.0f);
-		bBlockingHit = FloorSweepTest(Hit, CapsuleLocation, CapsuleLocation + CapsuleDown * TraceDist, CollisionChannel, CapsuleShape, QueryParams, ResponseParam);
+		bBlockingHit = CollisionSDFFloorSweepTest(Hit, CapsuleLocation, CapsuleLocation + CapsuleDown * TraceDist, CollisionChannel, CapsuleShape, QueryParams, ResponseParam);
 
 		if (bBlockingHit)
 		{
@@ -2727,6 +3069,12 @@ void UDashCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLoc
 				{
 					// Hit within test distance.
 					OutFloorResult.bWalkableFloor = true;
+
+					if (bEnableFloorCache)
+					{
+						UpdateFloorCache(FloorCache, CapsuleLocation, CapsuleDown * -1.0f, SweepDistance, SweepRadius, OutFloorResult);
+					}
+
 					return;
 				}
 			}
@@ -2750,6 +3098,7 @@ void UDashCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLoc
 		QueryParams.TraceTag = DashCharacterMovementComponentStatics::FloorLineTraceName;
 
 		FHitResult Hit(1.0f);
+		CountCollisionQuery(EDashCollisionQuery::FloorLineTrace);
 		bBlockingHit = GetWorld()->LineTraceSingleByChannel(Hit, LineTraceStart, LineTraceStart + CapsuleDown * TraceDist,
 			CollisionChannel, QueryParams, ResponseParam);
 
@@ -2781,6 +3130,7 @@ bool UDashCharacterMovementComponent::FloorSweepTest(FHitResult& OutHit, const F
 	const FCollisionShape& CollisionShape, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParam) const
 {
 	bool bBlockingHit = false;
+	CountCollisionQuery(EDashCollisionQuery::FloorSweep);
 
 	if (!bUseFlatBaseForFloorChecks)
 	{
@@ -2804,6 +3154,7 @@ bool UDashCharacterMovementComponent::FloorSweepTest(FHitResult& OutHit, const F
 		{
 			// Test again with the same box, not rotated.
 			OutHit.Reset(1.0f, false);
+			CountCollisionQuery(EDashCollisionQuery::FloorSweep);
 			bBlockingHit = GetWorld()->SweepSingleByChannel(OutHit, Start, End, BoxRotation, TraceChannel, BoxShape, Params, ResponseParam);
 		}
 	}
@@ -2811,6 +3162,66 @@ bool UDashCharacterMovementComponent::FloorSweepTest(FHitResult& OutHit, const F
 	return bBlockingHit;
 }
 
+bool UDashCharacterMovementComponent::CollisionSDFFloorSweepTest(FHitResult& OutHit, const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
+	const FCollisionShape& CollisionShape, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParam) const
+{
+	const UDashCollisionSDF* CollisionSDF = CollisionSDFSubsystem != nullptr ? CollisionSDFSubsystem->GetCollisionSDF() : nullptr;
+	if (!bUseCollisionSDF || CollisionSDF == nullptr || bUseFlatBaseForFloorChecks || !CollisionShape.IsCapsule() || TraceChannel != CollisionSDF->CollisionChannel)
+	{
+		return FloorSweepTest(OutHit, Start, End, TraceChannel, CollisionShape, Params, ResponseParam);
+	}
+
+	// Swept along its axis, a capsule first touches the floor with its bottom sphere.
+	const FVector SphereOffset = (End - Start).GetSafeNormal() * CollisionShape.GetCapsuleAxisHalfLength();
+	const FVector SphereStart = Start + SphereOffset;
+	const FVector SphereEnd = End + SphereOffset;
+	const float SphereRadius = CollisionShape.GetCapsuleRadius();
+
+	CountCollisionQuery(EDashCollisionQuery::CollisionSDF);
+
+	// Static collision that couldn't be baked is only in the physics scene.
+	FBox SweepBox(ForceInit);
+	SweepBox += SphereStart;
+	SweepBox += SphereEnd;
+	if (CollisionSDF->IsNearUnbakedCollision(SweepBox.ExpandBy(SphereRadius)))
+	{
+		return FloorSweepTest(OutHit, Start, End, TraceChannel, CollisionShape, Params, ResponseParam);
+	}
+
+	// Components that aren't static aren't baked.
+	FCollisionQueryParams DynamicParams(Params);
+	DynamicParams.MobilityType = EQueryMobilityType::Dynamic;
+
+	// Inflated by the error of the field, a sphere that misses proves the capsule misses static collision.
+	float Time = 1.0f;
+	bool bStartPenetrating = false;
+	if (!CollisionSDF->SphereTrace(SphereStart, SphereEnd, SphereRadius + CollisionSDF->GetErrorBound(), Time, bStartPenetrating))
+	{
+		return FloorSweepTest(OutHit, Start, End, TraceChannel, CollisionShape, DynamicParams, ResponseParam);
+	}
+
+	// On flat floors the field is exact; near edges, corners and curved surfaces, the physics scene gives the exact hit.
+	FHitResult StaticHit(1.0f);
+	if (bStartPenetrating || !CollisionSDFSubsystem->SweepSpherePlanar(StaticHit, SphereStart, SphereEnd, SphereRadius, Time))
+	{
+		return FloorSweepTest(OutHit, Start, End, TraceChannel, CollisionShape, Params, ResponseParam);
+	}
+
+	// The field hit the bottom sphere; report the capsule.
+	StaticHit.TraceStart = Start;
+	StaticHit.TraceEnd = End;
+	StaticHit.Location -= SphereOffset;
+
+	// Movable and stationary components may still be closer.
+	if (FloorSweepTest(OutHit, Start, End, TraceChannel, CollisionShape, DynamicParams, ResponseParam) && OutHit.Time <= StaticHit.Time)
+	{
+		return true;
+	}
+
+	OutHit = StaticHit;
+	return true;
+}
+
 bool UDashCharacterMovementComponent::IsValidLandingSpot(const FVector& CapsuleLocation, const FHitResult& Hit) const
 {
 	if (!Hit.bBlockingHit)
@@ -2955,6 +3366,10 @@ bool UDashCharacterMovementComponent::ComputePerchResult(const float TestRadius,
 bool UDashCharacterMovementComponent::StepUp(const FVector& GravDir, const FVector& Delta, const FHitResult& InHit, struct UCharacterMovementComponent::FStepDownResult* OutStepDownResult)
 {
 	SCOPE_CYCLE_COUNTER(STAT_CharStepUp);
+	CSV_SCOPED_TIMING_STAT(DashMovement, StepUp);
+
+	// Moves done while stepping up are counted apart.
+	TGuardValue<EDashCollisionQuery> MoveQueryGuard(MoveQuery, EDashCollisionQuery::StepUp);
 
 	if (!CanStepUp(InHit) || MaxStepHeight <= 0.0f)
 	{
@@ -3293,6 +3708,28 @@ void UDashCharacterMovementComponent::DisplayDebug(UCanvas* Canvas, const FDebug
 	T = FString::Printf(TEXT("%s In physicsvolume %s on base %s component %s gravity %s"), *GetMovementName(), (PhysicsVolume ? *PhysicsVolume->GetName() : TEXT("None")),
 		(BaseActor ? *BaseActor->GetName() : TEXT("None")), (BaseComponent ? *BaseComponent->GetName() : TEXT("None")), *GetGravity().ToString());
 	DisplayDebugManager.DrawString(T);
+
+	T = FString::Printf(TEXT("Client corrections: %d (gravity in saved moves %i)"), NumClientCorrections, DashCharacterMovementCVars::NetSaveGravityInMoves != 0);
+	DisplayDebugManager.DrawString(T);
+
+	T = FString::Printf(TEXT("Simulated LOD: %s (saved %.2f ms)"), *StaticEnum<EDashSimulatedMovementLOD>()->GetNameStringByValue((int64)SimulatedLOD), SimulatedLODSavedTime);
+	DisplayDebugManager.DrawString(T);
+
+	T = FString::Printf(TEXT("Substeps: %d (adaptive %i, curvature %.4f)"), LastNumSubsteps, bUseAdaptiveSubstepping != 0, AdaptiveCurvature);
+	DisplayDebugManager.DrawString(T);
+
+	const int32 CollisionQueryBudget = MaxCollisionQueriesPerTick > 0 ? MaxCollisionQueriesPerTick : DashCharacterMovementCVars::CollisionQueryBudget;
+	T = FString::Printf(TEXT("Collision queries: %d (budget %d)"), GetTotalCollisionQueries(), CollisionQueryBudget);
+	DisplayDebugManager.DrawString(T);
+
+	for (int32 Index = 0; Index < (int32)EDashCollisionQuery::MAX; Index++)
+	{
+		if (LastCollisionQueryCounts[Index] > 0)
+		{
+			T = FString::Printf(TEXT("   %s: %d"), *DashCharacterMovementComponentStatics::CollisionQueryNames[Index].ToString(), LastCollisionQueryCounts[Index]);
+			DisplayDebugManager.DrawString(T);
+		}
+	}
 }
 
 //float UCharacterMovementComponent::VisualizeMovement() const
@@ -3557,6 +3994,10 @@ void UDashCharacterMovementComponent::ClientAdjustPosition_Implementation(float
 	}
 	ClientData->AckMove(MoveIndex, *this);
 
+	NumClientCorrections++;
+	INC_DWORD_STAT(STAT_CharClientCorrections);
+	PerfCountersIncrement(TEXT("NumClientCorrections"));
+
 	// Received Location is relative to dynamic base.
 	if (bBaseRelativePosition)
 	{
@@ -3832,6 +4273,7 @@ void UDashCharacterMovementComponent::ApplyRepulsionForce(float DeltaSeconds)
 
 				// Trace to get the hit location on the capsule.
 				FHitResult Hit;
+				CountCollisionQuery(EDashCollisionQuery::RepulsionForce);
 				bool bHasHit = UpdatedPrimitive->LineTraceComponent(Hit, BodyLocation, LineTraceEnd, QueryParams);
 
 				FVector HitLoc = Hit.ImpactPoint;
@@ -3906,6 +4348,43 @@ void UDashCharacterMovementComponent::ApplyAccumulatedForces(float DeltaSeconds)
 }
 
 FVector UDashCharacterMovementComponent::GetGravity() const
+{
+	NumFrameStateQueries++;
+
+	if (!UpdateFrameStateGravityKey())
+	{
+		return ComputeGravity();
+	}
+
+	if (!FrameState.bGravityValid)
+	{
+		FrameState.Gravity = ComputeGravity();
+		FrameState.bGravityValid = true;
+	}
+
+	return FrameState.Gravity;
+}
+
+FVector UDashCharacterMovementComponent::ComputeGravity() const
+{
+	FVector FieldGravity;
+	const float FieldWeight = GetFieldGravity(FieldGravity);
+
+	if (FieldWeight <= 0.0f)
+	{
+		return GetComponentGravity();
+	}
+
+	if (FieldWeight >= 1.0f)
+	{
+		return FieldGravity;
+	}
+
+	// Blend with the component gravity at the boundary of the volumes.
+	return FieldGravity + GetComponentGravity() * (1.0f - FieldWeight);
+}
+
+FVector UDashCharacterMovementComponent::GetComponentGravity() const
 {
 	if (!CustomGravityDirection.IsZero())
 	{
@@ -3924,8 +4403,91 @@ FVector UDashCharacterMovementComponent::GetGravity() const
 	return FVector(0.0f, 0.0f, GetGravityZ());
 }
 
+float UDashCharacterMovementComponent::GetFieldGravity(FVector& OutGravity) const
+{
+	OutGravity = FVector::ZeroVector;
+
+	if (GravityField == nullptr || UpdatedComponent == nullptr || !GravityField->HasVolumes())
+	{
+		return 0.0f;
+	}
+
+	const float Weight = GravityField->GetGravityAt(UpdatedComponent->GetComponentLocation(), OutGravity);
+	OutGravity *= FMath::Abs(UPawnMovementComponent::GetGravityZ()) * GravityScale;
+
+	return Weight;
+}
+
 FVector UDashCharacterMovementComponent::GetGravityDirection(bool bAvoidZeroGravity) const
 {
+	NumFrameStateQueries++;
+
+	if (!UpdateFrameStateGravityKey())
+	{
+		return ComputeGravityDirection(bAvoidZeroGravity);
+	}
+
+	if (bAvoidZeroGravity)
+	{
+		if (!FrameState.bSafeGravityDirectionValid)
+		{
+			FrameState.SafeGravityDirection = ComputeGravityDirection(true);
+			FrameState.bSafeGravityDirectionValid = true;
+		}
+
+		return FrameState.SafeGravityDirection;
+	}
+
+	if (!FrameState.bGravityDirectionValid)
+	{
+		FrameState.GravityDirection = ComputeGravityDirection(false);
+		FrameState.bGravityDirectionValid = true;
+	}
+
+	return FrameState.GravityDirection;
+}
+
+bool UDashCharacterMovementComponent::UpdateFrameStateGravityKey() const
+{
+	if (!DashCharacterMovementCVars::FrameStateCache)
+	{
+		return false;
+	}
+
+	// Gravity only depends on the location with a gravity point or gravity volumes.
+	const FVector Location = (UpdatedComponent != nullptr && (!GravityPoint.IsZero() || (GravityField != nullptr && GravityField->HasVolumes()))) ?
+		UpdatedComponent->GetComponentLocation() : FVector::ZeroVector;
+
+	if (!FrameState.bGravityKeyValid || Location != FrameState.GravityLocation || CustomGravityDirection != FrameState.GravityCustomDirection ||
+		GravityPoint != FrameState.GravityPoint || GravityScale != FrameState.GravityScale)
+	{
+		FrameState.GravityLocation = Location;
+		FrameState.GravityCustomDirection = CustomGravityDirection;
+		FrameState.GravityPoint = GravityPoint;
+		FrameState.GravityScale = GravityScale;
+		FrameState.bGravityKeyValid = true;
+		FrameState.bGravityValid = false;
+		FrameState.bGravityDirectionValid = false;
+		FrameState.bSafeGravityDirectionValid = false;
+	}
+
+	return true;
+}
+
+FVector UDashCharacterMovementComponent::ComputeGravityDirection(bool bAvoidZeroGravity) const
+{
+	FVector FieldGravity;
+	const float FieldWeight = GetFieldGravity(FieldGravity);
+
+	if (FieldWeight > 0.0f)
+	{
+		const FVector Gravity = FieldWeight < 1.0f ? FieldGravity + GetComponentGravity() * (1.0f - FieldWeight) : FieldGravity;
+		if (!bAvoidZeroGravity || !Gravity.IsZero())
+		{
+			return Gravity.GetSafeNormal();
+		}
+	}
+
 	// Gravity direction can be influenced by the custom gravity scale value.
 	if (GravityScale != 0.0f)
 	{
@@ -3983,33 +4545,55 @@ void UDashCharacterMovementComponent::SetGravityDirection(const FVector& NewGrav
 
 FORCEINLINE void UDashCharacterMovementComponent::SetCustomGravityDirection(const FVector& NewCustomGravityDirection)
 {
-	bDirtyCustomGravityDirection = CustomGravityDirection != NewCustomGravityDirection;
 	CustomGravityDirection = NewCustomGravityDirection;
 }
 
-void UDashCharacterMovementComponent::ClientSetCustomGravityDirection_Implementation(const FVector& NewCustomGravityDirection)
+void UDashCharacterMovementComponent::OnRep_ReplicatedGravity()
 {
-	SetCustomGravityDirection(NewCustomGravityDirection);
-}
+	// Autonomous proxies align gravity to the floor themselves while walking.
+	const bool bLocallyAligned = bAlignCustomGravityToFloor && IsMovingOnGround() && CharacterOwner != nullptr &&
+		CharacterOwner->GetLocalRole() == ROLE_AutonomousProxy;
 
-void UDashCharacterMovementComponent::ClientClearCustomGravityDirection_Implementation()
-{
-	SetCustomGravityDirection(FVector::ZeroVector);
-}
+	if (!bLocallyAligned)
+	{
+		// Quantization doesn't keep the direction normalized.
+		SetCustomGravityDirection(ReplicatedGravity.Direction.GetSafeNormal());
+	}
 
-void UDashCharacterMovementComponent::ClientSetGravityPoint_Implementation(const FVector& NewGravityPoint)
-{
-	GravityPoint = NewGravityPoint;
+	GravityPoint = ReplicatedGravity.Point;
+	GravityScale = ReplicatedGravity.Scale;
 }
 
-void UDashCharacterMovementComponent::ClientClearGravityPoint_Implementation()
+void UDashCharacterMovementComponent::UpdateReplicatedGravity()
 {
-	GravityPoint = FVector::ZeroVector;
+	const bool bHadDirection = !ReplicatedGravity.Direction.IsZero();
+	const bool bHasDirection = !CustomGravityDirection.IsZero();
+
+	// Direction follows curved floors every tick; only replicate noticeable changes.
+	if (bHadDirection != bHasDirection || (bHasDirection &&
+		(ReplicatedGravity.Direction | CustomGravityDirection) < FMath::Cos(FMath::DegreesToRadians(GravityReplicationAngleThreshold))))
+	{
+		ReplicatedGravity.Direction = CustomGravityDirection;
+	}
+
+	if (GravityPoint.IsZero() != ReplicatedGravity.Point.IsZero() ||
+		FVector::DistSquared(GravityPoint, ReplicatedGravity.Point) > FMath::Square(GravityReplicationPointThreshold))
+	{
+		ReplicatedGravity.Point = GravityPoint;
+	}
+
+	if (GravityScale != ReplicatedGravity.Scale)
+	{
+		ReplicatedGravity.Scale = GravityScale;
+	}
 }
 
-void UDashCharacterMovementComponent::ClientSetGravityScale_Implementation(float NewGravityScale)
+void UDashCharacterMovementComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
-	GravityScale = NewGravityScale;
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UDashCharacterMovementComponent, ReplicatedGravity);
+	DOREPLIFETIME_CONDITION(UDashCharacterMovementComponent, ReplicatedPath, COND_SimulatedOnly);
 }
 
 void UDashCharacterMovementComponent::UpdateGravity(float DeltaTime)
@@ -4022,55 +4606,85 @@ void UDashCharacterMovementComponent::UpdateGravity(float DeltaTime)
 
 	if (!bDisableGravityReplication && CharacterOwner && CharacterOwner->HasAuthority() && GetNetMode() > NM_Standalone)
 	{
-		if (bDirtyCustomGravityDirection)
-		{
-			// Replicate custom gravity direction to clients.
-			(!CustomGravityDirection.IsZero()) ? ClientSetCustomGravityDirection(CustomGravityDirection) : ClientClearCustomGravityDirection();
-			bDirtyCustomGravityDirection = false;
-		}
-
-		if (OldGravityPoint != GravityPoint)
-		{
-			// Replicate gravity point to clients.
-			(!GravityPoint.IsZero()) ? ClientSetGravityPoint(GravityPoint) : ClientClearGravityPoint();
-			OldGravityPoint = GravityPoint;
-		}
-
-		if (OldGravityScale != GravityScale)
-		{
-			// Replicate gravity scale to clients.
-			ClientSetGravityScale(GravityScale);
-			OldGravityScale = GravityScale;
-		}
+		// Replicate gravity state to clients.
+		UpdateReplicatedGravity();
 	}
 
 	UpdateComponentRotation();
 }
 
 FRotator UDashCharacterMovementComponent::ConstrainComponentRotation(const FRotator& Rotation) const
+{
+	return ConstrainComponentQuat(Rotation.Quaternion()).Rotator();
+}
+
+FQuat UDashCharacterMovementComponent::ConstrainComponentQuat(const FQuat& Rotation) const
 {
 	// Keep current Z rotation axis of capsule, try to keep X axis of rotation.
-	return FRotationMatrix::MakeFromZX(GetComponentAxisZ(), Rotation.Vector()).Rotator();
+	return FRotationMatrix::MakeFromZX(GetComponentAxisZ(), Rotation.GetAxisX()).ToQuat();
+}
+
+namespace DashCharacterMovementComponentStatics
+{
+	FORCEINLINE FVector GetQuatAxisX(const FQuat& Rotation)
+	{
+		// Fast simplification of FQuat::RotateVector() with FVector(1,0,0).
+		const FVector QuatVector(Rotation.X, Rotation.Y, Rotation.Z);
+
+		return FVector(FMath::Square(Rotation.W) - QuatVector.SizeSquared(), Rotation.Z * Rotation.W * 2.0f,
+			Rotation.Y * Rotation.W * -2.0f) + QuatVector * (Rotation.X * 2.0f);
+	}
+
+	FORCEINLINE FVector GetQuatAxisZ(const FQuat& Rotation)
+	{
+		// Fast simplification of FQuat::RotateVector() with FVector(0,0,1).
+		const FVector QuatVector(Rotation.X, Rotation.Y, Rotation.Z);
+
+		return FVector(Rotation.Y * Rotation.W * 2.0f, Rotation.X * Rotation.W * -2.0f,
+			FMath::Square(Rotation.W) - QuatVector.SizeSquared()) + QuatVector * (Rotation.Z * 2.0f);
+	}
 }
 
 FORCEINLINE FVector UDashCharacterMovementComponent::GetComponentAxisX() const
 {
-	// Fast simplification of FQuat::RotateVector() with FVector(1,0,0).
+	NumFrameStateQueries++;
+
 	const FQuat ComponentRotation = UpdatedComponent->GetComponentQuat();
-	const FVector QuatVector(ComponentRotation.X, ComponentRotation.Y, ComponentRotation.Z);
+	if (!DashCharacterMovementCVars::FrameStateCache)
+	{
+		return DashCharacterMovementComponentStatics::GetQuatAxisX(ComponentRotation);
+	}
+
+	if (!FrameState.bAxesValid || !(ComponentRotation == FrameState.AxesRotation))
+	{
+		FrameState.AxesRotation = ComponentRotation;
+		FrameState.AxisX = DashCharacterMovementComponentStatics::GetQuatAxisX(ComponentRotation);
+		FrameState.AxisZ = DashCharacterMovementComponentStatics::GetQuatAxisZ(ComponentRotation);
+		FrameState.bAxesValid = true;
+	}
 
-	return FVector(FMath::Square(ComponentRotation.W) - QuatVector.SizeSquared(), ComponentRotation.Z * ComponentRotation.W * 2.0f,
-		ComponentRotation.Y * ComponentRotation.W * -2.0f) + QuatVector * (ComponentRotation.X * 2.0f);
+	return FrameState.AxisX;
 }
 
 FORCEINLINE FVector UDashCharacterMovementComponent::GetComponentAxisZ() const
 {
-	// Fast simplification of FQuat::RotateVector() with FVector(0,0,1).
+	NumFrameStateQueries++;
+
 	const FQuat ComponentRotation = UpdatedComponent->GetComponentQuat();
-	const FVector QuatVector(ComponentRotation.X, ComponentRotation.Y, ComponentRotation.Z);
+	if (!DashCharacterMovementCVars::FrameStateCache)
+	{
+		return DashCharacterMovementComponentStatics::GetQuatAxisZ(ComponentRotation);
+	}
+
+	if (!FrameState.bAxesValid || !(ComponentRotation == FrameState.AxesRotation))
+	{
+		FrameState.AxesRotation = ComponentRotation;
+		FrameState.AxisX = DashCharacterMovementComponentStatics::GetQuatAxisX(ComponentRotation);
+		FrameState.AxisZ = DashCharacterMovementComponentStatics::GetQuatAxisZ(ComponentRotation);
+		FrameState.bAxesValid = true;
+	}
 
-	return FVector(ComponentRotation.Y * ComponentRotation.W * 2.0f, ComponentRotation.X * ComponentRotation.W * -2.0f,
-		FMath::Square(ComponentRotation.W) - QuatVector.SizeSquared()) + QuatVector * (ComponentRotation.Z * 2.0f);
+	return FrameState.AxisZ;
 }
 
 FVector UDashCharacterMovementComponent::GetComponentDesiredAxisZ() const
@@ -4098,6 +4712,13 @@ void UDashCharacterMovementComponent::UpdateComponentRotation()
 
 	const FVector DesiredCapsuleUp = GetComponentDesiredAxisZ();
 
+	if (bDeferRotationUpdates)
+	{
+		DeferredAxisZ = DesiredCapsuleUp;
+		bHasDeferredAxisZ = true;
+		return;
+	}
+
 	// Abort if angle between new and old capsule 'up' axis almost equals to 0 degrees.
 	if ((DesiredCapsuleUp | GetComponentAxisZ()) >= THRESH_NORMALS_ARE_PARALLEL)
 	{
@@ -4105,8 +4726,1384 @@ void UDashCharacterMovementComponent::UpdateComponentRotation()
 	}
 
 	// Take desired Z rotation axis of capsule, try to keep current X rotation axis of capsule.
-	const FMatrix RotationMatrix = FRotationMatrix::MakeFromZX(DesiredCapsuleUp, GetComponentAxisX());
+	const FQuat NewRotation = FRotationMatrix::MakeFromZX(DesiredCapsuleUp, GetComponentAxisX()).ToQuat();
 
 	// Intentionally not using MoveUpdatedComponent to bypass constraints.
-	UpdatedComponent->MoveComponent(FVector::ZeroVector, RotationMatrix.Rotator(), true);
+	UpdatedComponent->MoveComponent(FVector::ZeroVector, NewRotation, true);
+}
+
+void UDashCharacterMovementComponent::PerformMovement(float DeltaTime)
+{
+	if (!bUseFixedTimeStep || !CanUseFixedTimeStep())
+	{
+		if (bFixedTimeStepActive)
+		{
+			ResetFixedTimeStep();
+		}
+
+		Super::PerformMovement(DeltaTime);
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_CharFixedTimeStep);
+
+	const float FixedDeltaTime = 1.0f / FMath::Max(FixedTimeStepRate, 1.0f);
+
+	if (!bFixedTimeStepActive)
+	{
+		// Start interpolating from current state.
+		bFixedTimeStepActive = true;
+		FixedTimeStepAccumulator = 0.0f;
+		FixedTimeStepPreviousLocation = UpdatedComponent->GetComponentLocation();
+		FixedTimeStepPreviousRotation = UpdatedComponent->GetComponentQuat();
+	}
+
+	// Drop the time that can't be simulated this frame; hitches slow down the simulation instead of making the frame longer.
+	FixedTimeStepAccumulator = FMath::Min(FixedTimeStepAccumulator + DeltaTime, FixedDeltaTime * FMath::Max(MaxFixedTimeSteps, 1));
+
+	int32 Steps = 0;
+	while (FixedTimeStepAccumulator >= FixedDeltaTime)
+	{
+		FixedTimeStepPreviousLocation = UpdatedComponent->GetComponentLocation();
+		FixedTimeStepPreviousRotation = UpdatedComponent->GetComponentQuat();
+
+		Super::PerformMovement(FixedDeltaTime);
+
+		FixedTimeStepAccumulator -= FixedDeltaTime;
+		Steps++;
+
+		if (!HasValidData() || !bFixedTimeStepActive)
+		{
+			// Destroyed, teleported out of the mode or reset during the step.
+			return;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_CharFixedTimeStepSteps, Steps);
+
+	if (Steps == 0)
+	{
+		// Jump input is consumed by PerformMovement; keep its hold time consistent on frames without a step.
+		CharacterOwner->ClearJumpInput(DeltaTime);
+	}
+
+	InterpolateFixedTimeStepMesh(FixedTimeStepAccumulator / FixedDeltaTime);
+}
+
+bool UDashCharacterMovementComponent::CanUseFixedTimeStep() const
+{
+	// Moves of remote autonomous proxies are driven by client time stamps and simulated proxies don't perform movement.
+	return CharacterOwner != nullptr && CharacterOwner->GetLocalRole() == ROLE_Authority &&
+		(CharacterOwner->IsLocallyControlled() || CharacterOwner->Controller == nullptr);
+}
+
+void UDashCharacterMovementComponent::InterpolateFixedTimeStepMesh(float Alpha)
+{
+	USkeletalMeshComponent* Mesh = CharacterOwner ? CharacterOwner->GetMesh() : nullptr;
+	if (Mesh == nullptr || Mesh->GetAttachParent() != UpdatedComponent)
+	{
+		return;
+	}
+
+	Alpha = FMath::Clamp(Alpha, 0.0f, 1.0f);
+
+	// Capsule transform at render time, lagging at most one fixed step behind simulation.
+	const FTransform InterpolatedTransform(FQuat::Slerp(FixedTimeStepPreviousRotation, UpdatedComponent->GetComponentQuat(), Alpha),
+		FMath::Lerp(FixedTimeStepPreviousLocation, UpdatedComponent->GetComponentLocation(), Alpha), UpdatedComponent->GetComponentScale());
+
+	const FTransform MeshOffset(CharacterOwner->GetBaseRotationOffset(), CharacterOwner->GetBaseTranslationOffset());
+	Mesh->SetWorldTransform(MeshOffset * InterpolatedTransform, false, nullptr, ETeleportType::TeleportPhysics);
+}
+
+void UDashCharacterMovementComponent::ResetFixedTimeStep()
+{
+	bFixedTimeStepActive = false;
+	FixedTimeStepAccumulator = 0.0f;
+
+	USkeletalMeshComponent* Mesh = CharacterOwner ? CharacterOwner->GetMesh() : nullptr;
+	if (Mesh != nullptr && Mesh->GetAttachParent() == UpdatedComponent)
+	{
+		Mesh->SetRelativeLocationAndRotation(CharacterOwner->GetBaseTranslationOffset(), CharacterOwner->GetBaseRotationOffset(), false, nullptr, ETeleportType::TeleportPhysics);
+	}
+}
+
+void UDashCharacterMovementComponent::InvalidateFloorCache()
+{
+	FloorCache.bValid = false;
+	FloorCache.FloorResult.Clear();
+
+	// A pending probe was predicted from the state being discarded.
+	AsyncFloorProbe.bValid = false;
+	AsyncFloorProbeHandle = FTraceHandle();
+}
+
+bool UDashCharacterMovementComponent::ComputeCachedFloorDist(const FDashFloorCache& Cache, float MaxMoveDistance, const FVector& CapsuleLocation, float SweepDistance, float SweepRadius, FFindFloorResult& OutFloorResult) const
+{
+	if (!Cache.bValid)
+	{
+		return false;
+	}
+
+	float PawnRadius, PawnHalfHeight;
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(PawnRadius, PawnHalfHeight);
+
+	const FVector CapsuleUp = GetComponentAxisZ();
+	const FVector CapsuleDelta = CapsuleLocation - Cache.CapsuleLocation;
+	const UPrimitiveComponent* FloorComponent = Cache.FloorResult.HitResult.Component.Get();
+
+	// The cached sweep must cover this query and the capsule must have barely moved on the same, unmoved floor.
+	if (FloorComponent == nullptr || SweepDistance > Cache.SweepDistance || SweepRadius != Cache.SweepRadius ||
+		PawnRadius != Cache.CapsuleRadius || PawnHalfHeight != Cache.CapsuleHalfHeight || (CapsuleUp | Cache.CapsuleUp) < 1.0f - KINDA_SMALL_NUMBER ||
+		CapsuleDelta.SizeSquared() > FMath::Square(MaxMoveDistance) || !FloorComponent->GetComponentTransform().Equals(Cache.FloorTransform, KINDA_SMALL_NUMBER))
+	{
+		return false;
+	}
+
+	// Move the contact along the cached floor plane: the sweep distance changes by the capsule displacement along the plane normal.
+	const FHitResult& CachedHit = Cache.FloorResult.HitResult;
+	const FVector& FloorNormal = CachedHit.ImpactNormal;
+	const float FloorDist = Cache.FloorResult.FloorDist + (CapsuleDelta | FloorNormal) / (CapsuleUp | FloorNormal);
+	const float MaxPenetrationAdjust = FMath::Max(MAX_FLOOR_DIST, PawnRadius);
+
+	if (FloorDist > SweepDistance || FloorDist < -MaxPenetrationAdjust)
+	{
+		return false;
+	}
+
+	const FVector LocationDelta = CapsuleDelta + CapsuleUp * (Cache.FloorResult.FloorDist - FloorDist);
+	const FVector NewImpactPoint = CachedHit.ImpactPoint + LocationDelta;
+
+	// Reject contacts that slid to the edge of the capsule, a real sweep must decide.
+	if (!IsWithinEdgeToleranceEx(CapsuleLocation, CapsuleUp * -1.0f, SweepRadius, NewImpactPoint))
+	{
+		return false;
+	}
+
+	FHitResult Hit = CachedHit;
+	const float TraceDist = (Hit.TraceEnd - Hit.TraceStart).Size();
+	Hit.TraceStart += CapsuleDelta;
+	Hit.TraceEnd += CapsuleDelta;
+	Hit.Location += LocationDelta;
+	Hit.ImpactPoint = NewImpactPoint;
+	Hit.Distance += FloorDist - Cache.FloorResult.FloorDist;
+	Hit.Time = TraceDist > KINDA_SMALL_NUMBER ? FMath::Clamp(Hit.Distance / TraceDist, 0.0f, 1.0f) : Hit.Time;
+
+	OutFloorResult.SetFromSweep(Hit, FloorDist, true);
+
+	return true;
+}
+
+void UDashCharacterMovementComponent::UpdateFloorCache(FDashFloorCache& Cache, const FVector& CapsuleLocation, const FVector& CapsuleUp, float SweepDistance, float SweepRadius, const FFindFloorResult& FloorResult) const
+{
+	const FHitResult& Hit = FloorResult.HitResult;
+	const UPrimitiveComponent* FloorComponent = Hit.Component.Get();
+
+	// Only planar contacts with static or kinematic floors can be projected.
+	if (FloorComponent == nullptr || FloorComponent->IsSimulatingPhysics() || Hit.bStartPenetrating || FloorResult.bLineTrace ||
+		!FloorResult.bWalkableFloor || !Hit.Normal.Equals(Hit.ImpactNormal, KINDA_SMALL_NUMBER) || (CapsuleUp | Hit.ImpactNormal) <= KINDA_SMALL_NUMBER)
+	{
+		Cache.bValid = false;
+		return;
+	}
+
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(Cache.CapsuleRadius, Cache.CapsuleHalfHeight);
+
+	Cache.FloorResult = FloorResult;
+	Cache.FloorTransform = FloorComponent->GetComponentTransform();
+	Cache.CapsuleLocation = CapsuleLocation;
+	Cache.CapsuleUp = CapsuleUp;
+	Cache.SweepDistance = SweepDistance;
+	Cache.SweepRadius = SweepRadius;
+	Cache.bValid = true;
+}
+
+void UDashCharacterMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	// Physics volumes and other engine state can change gravity between ticks without changing the cache keys.
+	FrameState.Invalidate();
+
+	const bool bIsSimulatedProxy = HasValidData() && CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy;
+	if (bIsSimulatedProxy)
+	{
+		UpdateSimulatedLOD();
+	}
+
+	const uint32 StartCycles = FPlatformTime::Cycles();
+
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (bIsSimulatedProxy)
+	{
+		RecordSimulatedLODCost(DeltaTime, FPlatformTime::Cycles() - StartCycles);
+	}
+
+	// Predicted floor is only valid for the move it was predicted for.
+	AsyncFloorProbe.bValid = false;
+	AsyncFloorProbeHandle = FTraceHandle();
+
+	if (bUseAsyncFloorProbe && !bUseFlatBaseForFloorChecks && HasValidData() && CharacterOwner->GetLocalRole() > ROLE_SimulatedProxy)
+	{
+		RequestAsyncFloorProbe(DeltaTime);
+	}
+
+	FlushCollisionQueryCounts();
+
+	LastNumSubsteps = NumSubsteps;
+	NumSubsteps = 0;
+
+	// Updates that returned before OnMovementUpdated.
+	FlushDeferredRotation();
+
+	INC_DWORD_STAT_BY(STAT_CharFrameStateQueries, NumFrameStateQueries);
+	LastNumFrameStateQueries = NumFrameStateQueries;
+	NumFrameStateQueries = 0;
+}
+
+void UDashCharacterMovementComponent::RequestAsyncFloorProbe(float DeltaTime)
+{
+	FCollisionShape CapsuleShape;
+	FVector Start, End;
+	if (!BeginFloorProbe(DeltaTime, CapsuleShape, Start, End))
+	{
+		return;
+	}
+
+	FCollisionQueryParams QueryParams(DashCharacterMovementComponentStatics::AsyncFloorProbeName, false, CharacterOwner);
+	FCollisionResponseParams ResponseParam;
+	InitCollisionParams(QueryParams, ResponseParam);
+
+	CountCollisionQuery(EDashCollisionQuery::AsyncFloorProbe);
+	AsyncFloorProbeHandle = GetWorld()->AsyncSweepByChannel(EAsyncTraceType::Single, Start, End, UpdatedComponent->GetComponentQuat(),
+		UpdatedComponent->GetCollisionObjectType(), CapsuleShape, QueryParams, ResponseParam);
+	AsyncFloorProbeFrame = GFrameCounter;
+}
+
+bool UDashCharacterMovementComponent::CollectAsyncFloorProbe() const
+{
+	if (AsyncFloorProbeHandle.IsValid())
+	{
+		// Results of older frames are discarded by the world.
+		FTraceDatum TraceData;
+		if (AsyncFloorProbeFrame >= GFrameCounter || !GetWorld()->QueryTraceData(AsyncFloorProbeHandle, TraceData))
+		{
+			return false;
+		}
+
+		AsyncFloorProbeHandle = FTraceHandle();
+
+		if (TraceData.OutHits.Num() > 0)
+		{
+			FinishFloorProbe(TraceData.OutHits[0], (TraceData.End - TraceData.Start).Size());
+		}
+	}
+
+	return AsyncFloorProbe.bValid;
+}
+
+bool UDashCharacterMovementComponent::BeginFloorProbe(float DeltaTime, FCollisionShape& OutCapsuleShape, FVector& OutStart, FVector& OutEnd) const
+{
+	AsyncFloorProbe.bValid = false;
+
+	if ((!IsMovingOnGround() && !IsFalling()) || !UpdatedComponent->IsQueryCollisionEnabled() || DeltaTime < MIN_TICK_TIME)
+	{
+		return false;
+	}
+
+	float PawnRadius, PawnHalfHeight;
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(PawnRadius, PawnHalfHeight);
+
+	// Floors support walking characters; only falling characters follow gravity.
+	FVector PredictedLocation = UpdatedComponent->GetComponentLocation() + Velocity * DeltaTime;
+	if (IsFalling())
+	{
+		PredictedLocation += GetGravity() * (0.5f * FMath::Square(DeltaTime));
+	}
+
+	// Same distance and shrunk capsule as the first sweep of a walking floor check; falling checks are shorter and also covered.
+	const FVector CapsuleUp = GetComponentAxisZ();
+	const float SweepDistance = FMath::Max(MAX_FLOOR_DIST, MaxStepHeight + MAX_FLOOR_DIST + KINDA_SMALL_NUMBER);
+	AsyncFloorProbeShrinkHeight = (PawnHalfHeight - PawnRadius) * 0.1f;
+
+	OutCapsuleShape = FCollisionShape::MakeCapsule(PawnRadius, PawnHalfHeight - AsyncFloorProbeShrinkHeight);
+	OutStart = PredictedLocation;
+	OutEnd = PredictedLocation - CapsuleUp * (SweepDistance + AsyncFloorProbeShrinkHeight);
+
+	// Remember the query; the result is filled in once the sweep is done.
+	AsyncFloorProbe.CapsuleLocation = PredictedLocation;
+	AsyncFloorProbe.CapsuleUp = CapsuleUp;
+	AsyncFloorProbe.SweepDistance = SweepDistance;
+	AsyncFloorProbe.SweepRadius = PawnRadius;
+
+	return true;
+}
+
+void UDashCharacterMovementComponent::FinishFloorProbe(const FHitResult& Hit, float TraceDist) const
+{
+	const FVector CapsuleDown = AsyncFloorProbe.CapsuleUp * -1.0f;
+
+	// Same acceptance rules as the synchronous sweep in ComputeFloorDist.
+	if (!Hit.IsValidBlockingHit() || Hit.bStartPenetrating || !IsWalkable(Hit) ||
+		!IsWithinEdgeToleranceEx(AsyncFloorProbe.CapsuleLocation, CapsuleDown, AsyncFloorProbe.SweepRadius, Hit.ImpactPoint))
+	{
+		AsyncFloorProbe.bValid = false;
+		return;
+	}
+
+	const float FloorDist = Hit.Time * TraceDist - AsyncFloorProbeShrinkHeight;
+	if (FloorDist > AsyncFloorProbe.SweepDistance)
+	{
+		AsyncFloorProbe.bValid = false;
+		return;
+	}
+
+	FFindFloorResult FloorResult;
+	FloorResult.SetFromSweep(Hit, FMath::Max(-FMath::Max(MAX_FLOOR_DIST, AsyncFloorProbe.SweepRadius), FloorDist), true);
+
+	UpdateFloorCache(AsyncFloorProbe, AsyncFloorProbe.CapsuleLocation, AsyncFloorProbe.CapsuleUp, AsyncFloorProbe.SweepDistance,
+		AsyncFloorProbe.SweepRadius, FloorResult);
+}
+
+void UDashCharacterMovementComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UDashMovementManager* MovementManager = GetWorld()->GetSubsystem<UDashMovementManager>())
+	{
+		MovementManager->RegisterComponent(this);
+	}
+
+	SimulatedLODBaseTickInterval = PrimaryComponentTick.TickInterval;
+
+	// Load the collision distance field of the map once, before it's queried.
+	CollisionSDFSubsystem = bUseCollisionSDF ? GetWorld()->GetSubsystem<UDashCollisionSDFSubsystem>() : nullptr;
+	if (CollisionSDFSubsystem != nullptr && CollisionSDFSubsystem->LoadCollisionSDF() == nullptr)
+	{
+		CollisionSDFSubsystem = nullptr;
+	}
+
+	GravityField = bUseGravityField ? GetWorld()->GetSubsystem<UDashGravityFieldSubsystem>() : nullptr;
+	RingSubsystem = GetWorld()->GetSubsystem<UDashRingSubsystem>();
+
+	// Movement sets its own tick interval from the detail level.
+	SignificanceManager = bUseSignificanceForSimulatedLOD && CharacterOwner != nullptr ? GetWorld()->GetSubsystem<UDashSignificanceManager>() : nullptr;
+	if (SignificanceManager != nullptr)
+	{
+		SignificanceManager->RegisterActor(CharacterOwner, false);
+	}
+}
+
+void UDashCharacterMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UDashMovementManager* MovementManager = GetWorld()->GetSubsystem<UDashMovementManager>())
+	{
+		MovementManager->UnregisterComponent(this);
+	}
+
+	if (SignificanceManager != nullptr)
+	{
+		SignificanceManager->UnregisterActor(CharacterOwner);
+		SignificanceManager = nullptr;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool UDashCharacterMovementComponent::ShouldPrepareMovement() const
+{
+	// Asynchronous probes already predict the floor; simulated proxies don't run full floor checks.
+	return bUseMovementPrepass && !bUseAsyncFloorProbe && IsComponentTickEnabled() && HasValidData() && CharacterOwner->GetLocalRole() > ROLE_SimulatedProxy &&
+		(IsMovingOnGround() || IsFalling());
+}
+
+void UDashCharacterMovementComponent::PrepareMovement(float DeltaTime)
+{
+	FCollisionShape CapsuleShape;
+	FVector Start, End;
+	if (!BeginFloorProbe(DeltaTime, CapsuleShape, Start, End))
+	{
+		return;
+	}
+
+	FCollisionQueryParams QueryParams(DashCharacterMovementComponentStatics::ComputeFloorDistName, false, CharacterOwner);
+	FCollisionResponseParams ResponseParam;
+	InitCollisionParams(QueryParams, ResponseParam);
+
+	FHitResult Hit(1.0f);
+	if (FloorSweepTest(Hit, Start, End, UpdatedComponent->GetCollisionObjectType(), CapsuleShape, QueryParams, ResponseParam))
+	{
+		FinishFloorProbe(Hit, (End - Start).Size());
+	}
+}
+
+bool UDashCharacterMovementComponent::StartGrinding(USplineComponent* Spline)
+{
+	if (!HasValidData() || Spline == nullptr)
+	{
+		return false;
+	}
+
+	// Rebuild the table only for a new spline.
+	if (GrindArcTable.GetSpline() != Spline || !GrindArcTable.IsValid())
+	{
+		GrindArcTable.Build(Spline, GrindSampleDistance);
+	}
+
+	if (!GrindArcTable.IsValid())
+	{
+		GrindArcTable.Reset();
+		return false;
+	}
+
+	GrindSpline = Spline;
+	GrindDistance = GrindArcTable.FindDistanceClosestToWorldLocation(UpdatedComponent->GetComponentLocation());
+	GrindSpeed = Velocity | GrindArcTable.GetDirectionAtDistance(GrindDistance);
+
+	SetMovementMode(MOVE_Custom, CMOVE_Grinding);
+	return true;
+}
+
+void UDashCharacterMovementComponent::StopGrinding()
+{
+	if (IsGrinding())
+	{
+		SetMovementMode(MOVE_Falling);
+	}
+}
+
+bool UDashCharacterMovementComponent::IsGrinding() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == CMOVE_Grinding;
+}
+
+USplineComponent* UDashCharacterMovementComponent::GetGrindSpline() const
+{
+	return IsGrinding() ? GrindSpline : nullptr;
+}
+
+bool UDashCharacterMovementComponent::CanAttemptJump() const
+{
+	return Super::CanAttemptJump() || (IsJumpAllowed() && !bWantsToCrouch && IsGrinding());
+}
+
+void UDashCharacterMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
+{
+	if (CustomMovementMode == CMOVE_Grinding)
+	{
+		PhysGrinding(deltaTime, Iterations);
+	}
+	else
+	{
+		Super::PhysCustom(deltaTime, Iterations);
+	}
+}
+
+void UDashCharacterMovementComponent::PhysGrinding(float deltaTime, int32 Iterations)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CharPhysGrinding);
+	CSV_SCOPED_TIMING_STAT(DashMovement, PhysGrinding);
+
+	if (deltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	if (GrindSpline == nullptr || !GrindArcTable.IsValid())
+	{
+		if (CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy)
+		{
+			// Simulated proxies don't know the rail, extrapolate.
+			MoveUpdatedComponent(Velocity * deltaTime, UpdatedComponent->GetComponentQuat(), false);
+		}
+		else
+		{
+			StopGrinding();
+			StartNewPhysics(deltaTime, Iterations);
+		}
+
+		return;
+	}
+
+	Iterations++;
+	bJustTeleported = false;
+
+	// Accelerate along the rail with gravity and input.
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FVector OldDirection = GrindArcTable.GetDirectionAtDistance(GrindDistance);
+	GrindSpeed += ((GetGravity() + Acceleration) | OldDirection) * deltaTime;
+
+	if (GrindBrakingDeceleration > 0.0f && Acceleration.IsZero())
+	{
+		GrindSpeed = FMath::Sign(GrindSpeed) * FMath::Max(FMath::Abs(GrindSpeed) - GrindBrakingDeceleration * deltaTime, 0.0f);
+	}
+
+	const float MaxGrindSpeed = FMath::Max(GetMaxSpeed(), GrindMinSpeed);
+	GrindSpeed = FMath::Sign(GrindSpeed == 0.0f ? 1.0f : GrindSpeed) * FMath::Clamp(FMath::Abs(GrindSpeed), GrindMinSpeed, MaxGrindSpeed);
+
+	// Leave open rails at their ends with the time left.
+	float NewDistance = GrindDistance + GrindSpeed * deltaTime;
+	float RemainingTime = 0.0f;
+	const bool bReachedEnd = !GrindArcTable.IsClosedLoop() && (NewDistance <= 0.0f || NewDistance >= GrindArcTable.GetLength());
+	if (bReachedEnd)
+	{
+		const float EndDistance = NewDistance <= 0.0f ? 0.0f : GrindArcTable.GetLength();
+		const float Travel = NewDistance - GrindDistance;
+		RemainingTime = FMath::Abs(Travel) > KINDA_SMALL_NUMBER ? deltaTime * (NewDistance - EndDistance) / Travel : 0.0f;
+		NewDistance = EndDistance;
+	}
+
+	NewDistance = GrindArcTable.WrapDistance(NewDistance);
+
+	const FVector NewDirection = GrindArcTable.GetDirectionAtDistance(NewDistance);
+	const FVector NewUp = GrindArcTable.GetUpVectorAtDistance(NewDistance);
+	const FVector NewLocation = GrindArcTable.GetLocationAtDistance(NewDistance) +
+		NewUp * (CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + GrindHeightOffset);
+	const FVector Delta = NewLocation - OldLocation;
+
+	// Cheap obstacle probe along the move instead of a capsule sweep.
+	const float ProbeLength = Delta.Size() + CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	if (ProbeLength > KINDA_SMALL_NUMBER)
+	{
+		FCollisionQueryParams QueryParams(DashCharacterMovementComponentStatics::GrindProbeName, false, CharacterOwner);
+		QueryParams.AddIgnoredActor(GrindSpline->GetOwner());
+		FCollisionResponseParams ResponseParam;
+		InitCollisionParams(QueryParams, ResponseParam);
+
+		FHitResult Hit(1.0f);
+		CountCollisionQuery(EDashCollisionQuery::GrindProbe);
+		if (GetWorld()->LineTraceSingleByChannel(Hit, OldLocation, OldLocation + Delta.GetSafeNormal() * ProbeLength,
+			UpdatedComponent->GetCollisionObjectType(), QueryParams, ResponseParam))
+		{
+			// Knocked off the rail.
+			Velocity = OldDirection * GrindSpeed;
+			HandleImpact(Hit, deltaTime, Delta);
+			StopGrinding();
+			StartNewPhysics(deltaTime, Iterations);
+			return;
+		}
+	}
+
+	const FQuat NewRotation = bAlignComponentToGrindSpline ?
+		FRotationMatrix::MakeFromZX(NewUp, NewDirection * FMath::Sign(GrindSpeed)).ToQuat() : UpdatedComponent->GetComponentQuat();
+
+	MoveUpdatedComponent(Delta, NewRotation, false);
+
+	GrindDistance = NewDistance;
+	Velocity = NewDirection * GrindSpeed;
+
+	if (bReachedEnd)
+	{
+		StopGrinding();
+		StartNewPhysics(RemainingTime, Iterations);
+	}
+}
+
+bool UDashCharacterMovementComponent::SetPathLock(USplineComponent* Path)
+{
+	if (!HasValidData() || Path == nullptr)
+	{
+		return false;
+	}
+
+	if (PathLockArcTable.GetSpline() != Path || !PathLockArcTable.IsValid())
+	{
+		PathLockArcTable.Build(Path, GrindSampleDistance);
+	}
+
+	if (!PathLockArcTable.IsValid())
+	{
+		PathLockArcTable.Reset();
+		return false;
+	}
+
+	if (!IsPathLocked())
+	{
+		bPathLockSavedConstrainToPlane = bConstrainToPlane;
+		PathLockSavedPlaneNormal = PlaneConstraintNormal;
+		PathLockSavedAxisSetting = GetPlaneConstraintAxisSetting();
+	}
+
+	PathLockSpline = Path;
+	PathLockDistance = PathLockArcTable.FindDistanceClosestToWorldLocation(UpdatedComponent->GetComponentLocation());
+	PathLockLastLocation = UpdatedComponent->GetComponentLocation();
+
+	SetPlaneConstraintEnabled(true);
+	SetPlaneConstraintNormal(PathLockArcTable.GetRightVectorAtDistance(PathLockDistance));
+	UpdatePathLock();
+
+	return true;
+}
+
+void UDashCharacterMovementComponent::ClearPathLock()
+{
+	if (!IsPathLocked())
+	{
+		return;
+	}
+
+	PathLockSpline = nullptr;
+	PathLockArcTable.Reset();
+	PendingPathLockCorrection = FVector::ZeroVector;
+
+	SetPlaneConstraintNormal(PathLockSavedPlaneNormal);
+	SetPlaneConstraintAxisSetting(PathLockSavedAxisSetting);
+	SetPlaneConstraintEnabled(bPathLockSavedConstrainToPlane);
+}
+
+bool UDashCharacterMovementComponent::IsPathLocked() const
+{
+	return PathLockSpline != nullptr && PathLockArcTable.IsValid();
+}
+
+float UDashCharacterMovementComponent::GetPathLockDistance() const
+{
+	return IsPathLocked() ? PathLockDistance : 0.0f;
+}
+
+void UDashCharacterMovementComponent::UpdatePathLock()
+{
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+
+	// Only search around the last distance, as far as the character moved since, whatever the length of the substeps.
+	const float SearchDistance = FVector::Dist(Location, PathLockLastLocation) * 2.0f + GrindSampleDistance;
+	PathLockDistance = PathLockArcTable.FindDistanceClosestToWorldLocation(Location, PathLockDistance, SearchDistance);
+	PathLockLastLocation = Location;
+
+	// Moved without a teleport notification (e.g. by a moving base); the closest point is then stuck on the edge of the window,
+	// away from the character along the path, instead of across from it.
+	if (PathLockDistance > 0.0f && PathLockDistance < PathLockArcTable.GetLength() &&
+		FMath::Abs((Location - PathLockArcTable.GetLocationAtDistance(PathLockDistance)) | PathLockArcTable.GetDirectionAtDistance(PathLockDistance)) >
+		GrindSampleDistance * DashCharacterMovementComponentStatics::PathLockReacquireSamples)
+	{
+		PathLockDistance = PathLockArcTable.FindDistanceClosestToWorldLocation(Location);
+	}
+
+	const FVector PathNormal = PathLockArcTable.GetRightVectorAtDistance(PathLockDistance);
+	if (PathNormal.IsZero())
+	{
+		return;
+	}
+
+	// Turn velocity with the path, so speed along the path is kept in curves.
+	if ((PathNormal | PlaneConstraintNormal) < 1.0f - KINDA_SMALL_NUMBER && !PlaneConstraintNormal.IsZero())
+	{
+		Velocity = FQuat::FindBetweenNormals(PlaneConstraintNormal, PathNormal).RotateVector(Velocity);
+	}
+
+	SetPlaneConstraintNormal(PathNormal);
+	Velocity = FVector::VectorPlaneProject(Velocity, PathNormal);
+	Acceleration = FVector::VectorPlaneProject(Acceleration, PathNormal);
+
+	// Lateral drift is removed by the next move instead of an extra sweep.
+	PendingPathLockCorrection = PathNormal * ((PathLockArcTable.GetLocationAtDistance(PathLockDistance) - Location) | PathNormal);
+}
+
+bool UDashCharacterMovementComponent::MoveUpdatedComponentImpl(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult* OutHit, ETeleportType Teleport)
+{
+	if (bSweep)
+	{
+		CountCollisionQuery(MoveQuery);
+	}
+
+	if (UpdatedComponent && !PendingPathLockCorrection.IsZero() && !Delta.IsNearlyZero())
+	{
+		const FVector NewDelta = ConstrainDirectionToPlane(Delta) + PendingPathLockCorrection;
+		PendingPathLockCorrection = FVector::ZeroVector;
+
+		return UpdatedComponent->MoveComponent(NewDelta, NewRotation, bSweep, OutHit, MoveComponentFlags, Teleport);
+	}
+
+	return Super::MoveUpdatedComponentImpl(Delta, NewRotation, bSweep, OutHit, Teleport);
+}
+
+FNetworkPredictionData_Client* UDashCharacterMovementComponent::GetPredictionData_Client() const
+{
+	if (ClientPredictionData == nullptr)
+	{
+		UDashCharacterMovementComponent* MutableThis = const_cast<UDashCharacterMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_DashCharacter(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+bool UDashCharacterMovementComponent::ClientUpdatePositionAfterServerUpdate()
+{
+	// Saved moves replay the gravity of their time; gravity changed since then (replication, Blueprint, volumes) must survive.
+	const FVector LiveCustomGravityDirection = CustomGravityDirection;
+	const FVector LiveGravityPoint = GravityPoint;
+	const float LiveGravityScale = GravityScale;
+
+	const bool bResult = Super::ClientUpdatePositionAfterServerUpdate();
+
+	SetCustomGravityDirection(LiveCustomGravityDirection);
+	GravityPoint = LiveGravityPoint;
+	GravityScale = LiveGravityScale;
+
+	return bResult;
+}
+
+int32 UDashCharacterMovementComponent::GetNumClientCorrections() const
+{
+	return NumClientCorrections;
+}
+
+int32 UDashCharacterMovementComponent::GetNumCollisionQueries(EDashCollisionQuery Query) const
+{
+	return Query < EDashCollisionQuery::MAX ? LastCollisionQueryCounts[(int32)Query] : 0;
+}
+
+int32 UDashCharacterMovementComponent::GetTotalCollisionQueries() const
+{
+	int32 Total = 0;
+	for (int32 Count : LastCollisionQueryCounts)
+	{
+		Total += Count;
+	}
+
+	return Total;
+}
+
+void UDashCharacterMovementComponent::CountCollisionQuery(EDashCollisionQuery Query, int32 Count) const
+{
+	// Only the game thread or the prepass task of this component count, never both at once.
+	CollisionQueryCounts[(int32)Query] += Count;
+}
+
+void UDashCharacterMovementComponent::FlushCollisionQueryCounts()
+{
+	FMemory::Memcpy(LastCollisionQueryCounts, CollisionQueryCounts, sizeof(CollisionQueryCounts));
+	FMemory::Memzero(CollisionQueryCounts);
+
+	const int32 Total = GetTotalCollisionQueries();
+	if (Total == 0)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT_BY(STAT_CharQueries, Total);
+	INC_DWORD_STAT_BY(STAT_CharQueriesFloorSweep, LastCollisionQueryCounts[(int32)EDashCollisionQuery::FloorSweep]);
+	INC_DWORD_STAT_BY(STAT_CharQueriesFloorLineTrace, LastCollisionQueryCounts[(int32)EDashCollisionQuery::FloorLineTrace]);
+	INC_DWORD_STAT_BY(STAT_CharQueriesStepUp, LastCollisionQueryCounts[(int32)EDashCollisionQuery::StepUp]);
+	INC_DWORD_STAT_BY(STAT_CharQueriesMove, LastCollisionQueryCounts[(int32)EDashCollisionQuery::Move]);
+	INC_DWORD_STAT_BY(STAT_CharQueriesCheckLedgeDirection, LastCollisionQueryCounts[(int32)EDashCollisionQuery::CheckLedgeDirection]);
+	INC_DWORD_STAT_BY(STAT_CharQueriesCheckWaterJump, LastCollisionQueryCounts[(int32)EDashCollisionQuery::CheckWaterJump]);
+	INC_DWORD_STAT_BY(STAT_CharQueriesImmersionDepth, LastCollisionQueryCounts[(int32)EDashCollisionQuery::ImmersionDepth]);
+	INC_DWORD_STAT_BY(STAT_CharQueriesRepulsionForce, LastCollisionQueryCounts[(int32)EDashCollisionQuery::RepulsionForce]);
+	INC_DWORD_STAT_BY(STAT_CharQueriesCrouch, LastCollisionQueryCounts[(int32)EDashCollisionQuery::Crouch]);
+	INC_DWORD_STAT_BY(STAT_CharQueriesAsyncFloorProbe, LastCollisionQueryCounts[(int32)EDashCollisionQuery::AsyncFloorProbe]);
+	INC_DWORD_STAT_BY(STAT_CharQueriesGrindProbe, LastCollisionQueryCounts[(int32)EDashCollisionQuery::GrindProbe]);
+	INC_DWORD_STAT_BY(STAT_CharQueriesCollisionSDF, LastCollisionQueryCounts[(int32)EDashCollisionQuery::CollisionSDF]);
+
+#if CSV_PROFILER
+	for (int32 Index = 0; Index < (int32)EDashCollisionQuery::MAX; Index++)
+	{
+		if (LastCollisionQueryCounts[Index] > 0)
+		{
+			FCsvProfiler::RecordCustomStat(DashCharacterMovementComponentStatics::CollisionQueryNames[Index], CSV_CATEGORY_INDEX(DashMovement),
+				LastCollisionQueryCounts[Index], ECsvCustomStatOp::Accumulate);
+		}
+	}
+#endif
+
+	const int32 Budget = MaxCollisionQueriesPerTick > 0 ? MaxCollisionQueriesPerTick : DashCharacterMovementCVars::CollisionQueryBudget;
+	if (Budget > 0 && Total > Budget)
+	{
+		// Log at most once per second per character.
+		const float WorldTime = GetWorld()->GetTimeSeconds();
+		if (WorldTime - LastCollisionQueryWarningTime >= 1.0f || WorldTime < LastCollisionQueryWarningTime)
+		{
+			LastCollisionQueryWarningTime = WorldTime;
+
+			FString Breakdown;
+			for (int32 Index = 0; Index < (int32)EDashCollisionQuery::MAX; Index++)
+			{
+				if (LastCollisionQueryCounts[Index] > 0)
+				{
+					Breakdown += FString::Printf(TEXT(" %s=%d"), *DashCharacterMovementComponentStatics::CollisionQueryNames[Index].ToString(), LastCollisionQueryCounts[Index]);
+				}
+			}
+
+			UE_LOG(LogCharacterMovement, Warning, TEXT("%s issued %d collision queries in one tick (budget %d), mode %s:%s"),
+				*GetNameSafe(CharacterOwner), Total, Budget, *GetMovementName(), *Breakdown);
+		}
+	}
+}
+
+int32 UDashCharacterMovementComponent::GetNumSubsteps() const
+{
+	return LastNumSubsteps;
+}
+
+float UDashCharacterMovementComponent::GetAdaptiveSimulationTimeStep(float RemainingTime, int32 Iterations) const
+{
+	if (!bUseAdaptiveSubstepping)
+	{
+		return GetSimulationTimeStep(RemainingTime, Iterations);
+	}
+
+	float MaxTimeStep = AdaptiveMaxTimeStep;
+
+	const float Speed = Velocity.Size();
+	if (Speed > KINDA_SMALL_NUMBER)
+	{
+		// Don't cover more than a fraction of the capsule per substep, or thin geometry gets skipped.
+		MaxTimeStep = FMath::Min(MaxTimeStep, AdaptiveMaxStepRadiusRatio * CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius() / Speed);
+
+		// Don't let the floor turn by more than the maximum angle during the substep.
+		if (IsMovingOnGround() && AdaptiveCurvature > KINDA_SMALL_NUMBER)
+		{
+			MaxTimeStep = FMath::Min(MaxTimeStep, FMath::DegreesToRadians(AdaptiveMaxFloorAngle) / (AdaptiveCurvature * Speed));
+		}
+	}
+
+	// Split the remaining time evenly among the substeps it needs, within the iterations left.
+	const int32 IterationsLeft = FMath::Max(MaxSimulationIterations - Iterations + 1, 1);
+	const int32 Substeps = FMath::Clamp(FMath::CeilToInt(RemainingTime / FMath::Max(MaxTimeStep, MIN_TICK_TIME)), 1, IterationsLeft);
+
+	return FMath::Max(MIN_TICK_TIME, RemainingTime / Substeps);
+}
+
+void UDashCharacterMovementComponent::UpdateAdaptiveSubstep()
+{
+	NumSubsteps++;
+
+	if (!bUseAdaptiveSubstepping)
+	{
+		return;
+	}
+
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+
+	if (IsMovingOnGround() && CurrentFloor.IsWalkableFloor())
+	{
+		const FVector FloorNormal = CurrentFloor.HitResult.ImpactNormal;
+		const float Distance = (Location - AdaptiveLastLocation).Size();
+
+		if (!AdaptiveLastFloorNormal.IsZero() && Distance > KINDA_SMALL_NUMBER)
+		{
+			// Faceted curves turn at triangle edges only; hold the peaks and let them fade over a few substeps.
+			const float Angle = FMath::Acos(FMath::Clamp(FloorNormal | AdaptiveLastFloorNormal, -1.0f, 1.0f));
+			AdaptiveCurvature = FMath::Max(Angle / Distance, AdaptiveCurvature * 0.5f);
+		}
+
+		AdaptiveLastFloorNormal = FloorNormal;
+	}
+	else
+	{
+		AdaptiveLastFloorNormal = FVector::ZeroVector;
+		AdaptiveCurvature = 0.0f;
+	}
+
+	AdaptiveLastLocation = Location;
+}
+
+EDashSimulatedMovementLOD UDashCharacterMovementComponent::GetSimulatedMovementLOD() const
+{
+	return SimulatedLOD;
+}
+
+float UDashCharacterMovementComponent::GetSimulatedLODSavedTime() const
+{
+	return SimulatedLODSavedTime;
+}
+
+bool UDashCharacterMovementComponent::AddSimulatedSnapshot(const FVector& Location, const FQuat& Rotation)
+{
+	if (!bEnableSimulatedMovementLOD)
+	{
+		SimulatedSnapshots.Reset();
+		return false;
+	}
+
+	if (SimulatedSnapshots.Num() >= DashCharacterMovementComponentStatics::MaxSimulatedSnapshots)
+	{
+		SimulatedSnapshots.RemoveAt(0, 1, false);
+	}
+
+	SimulatedSnapshots.Add({ GetWorld()->GetTimeSeconds(), Location, Rotation, Velocity });
+	SimulatedLODTimeSinceUpdate = 0.0f;
+
+	return SimulatedLOD == EDashSimulatedMovementLOD::Interpolate;
+}
+
+void UDashCharacterMovementComponent::UpdateSimulatedLOD()
+{
+	EDashSimulatedMovementLOD NewLOD = EDashSimulatedMovementLOD::Full;
+	EDashSignificance Significance = EDashSignificance::Full;
+
+	if (bEnableSimulatedMovementLOD && SignificanceManager != nullptr && SignificanceManager->GetSignificance(CharacterOwner, Significance))
+	{
+		// Significance already accounts for view, speed and the scalability level.
+		NewLOD = Significance == EDashSignificance::Full ? EDashSimulatedMovementLOD::Full :
+			(Significance == EDashSignificance::Reduced ? EDashSimulatedMovementLOD::Extrapolate : EDashSimulatedMovementLOD::Interpolate);
+	}
+	else if (bEnableSimulatedMovementLOD)
+	{
+		// Distance to the closest local camera, scaled so zoomed in cameras keep details further away.
+		const FVector Location = UpdatedComponent->GetComponentLocation();
+		float Distance = BIG_NUMBER;
+
+		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+		{
+			const APlayerController* PlayerController = It->Get();
+			if (PlayerController != nullptr && PlayerController->IsLocalController() && PlayerController->PlayerCameraManager != nullptr)
+			{
+				const float HalfFOV = FMath::DegreesToRadians(FMath::Clamp(PlayerController->PlayerCameraManager->GetFOVAngle(), 1.0f, 170.0f) * 0.5f);
+				Distance = FMath::Min(Distance, FVector::Dist(Location, PlayerController->PlayerCameraManager->GetCameraLocation()) * FMath::Tan(HalfFOV));
+			}
+		}
+
+		const float Hysteresis = DashCharacterMovementComponentStatics::SimulatedLODHysteresis;
+		const float ExtrapolateDistance = SimulatedLODExtrapolateDistance * (SimulatedLOD != EDashSimulatedMovementLOD::Full ? Hysteresis : 1.0f);
+		const float InterpolateDistance = SimulatedLODInterpolateDistance * (SimulatedLOD == EDashSimulatedMovementLOD::Interpolate ? Hysteresis : 1.0f);
+
+		if (Distance >= InterpolateDistance)
+		{
+			NewLOD = EDashSimulatedMovementLOD::Interpolate;
+		}
+		else if (Distance >= ExtrapolateDistance)
+		{
+			NewLOD = EDashSimulatedMovementLOD::Extrapolate;
+		}
+
+		// Proxies nobody sees use the next lower detail level.
+		if (NewLOD != EDashSimulatedMovementLOD::Interpolate && !CharacterOwner->WasRecentlyRendered(SimulatedLODOffscreenTime))
+		{
+			NewLOD = (EDashSimulatedMovementLOD)((uint8)NewLOD + 1);
+		}
+	}
+
+	if (NewLOD == SimulatedLOD)
+	{
+		return;
+	}
+
+	// Interpolation lags behind; catch up with the latest snapshot and let the next simulation find the floor.
+	if (SimulatedLOD == EDashSimulatedMovementLOD::Interpolate && SimulatedSnapshots.Num() > 0)
+	{
+		const FDashSimulatedSnapshot& Snapshot = SimulatedSnapshots.Last();
+		UpdatedComponent->SetWorldLocationAndRotation(Snapshot.Location, Snapshot.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+		bNetworkUpdateReceived = true;
+		bJustTeleported = true;
+	}
+
+	SimulatedLOD = NewLOD;
+
+	float TickInterval = SimulatedLODBaseTickInterval;
+	if (SimulatedLOD == EDashSimulatedMovementLOD::Extrapolate)
+	{
+		TickInterval = FMath::Max(TickInterval, SimulatedLODExtrapolateTickInterval);
+	}
+	else if (SimulatedLOD == EDashSimulatedMovementLOD::Interpolate)
+	{
+		TickInterval = FMath::Max(TickInterval, SimulatedLODInterpolateTickInterval);
+	}
+
+	SetComponentTickInterval(TickInterval);
+}
+
+void UDashCharacterMovementComponent::SimulateMovementLOD(float DeltaSeconds)
+{
+	// Handle network changes; locations are applied by the owner or interpolated below.
+	if (bNetworkUpdateReceived)
+	{
+		bNetworkUpdateReceived = false;
+		bJustTeleported = false;
+
+		if (bNetworkMovementModeChanged)
+		{
+			bNetworkMovementModeChanged = false;
+			ApplyNetworkMovementMode(CharacterOwner->GetReplicatedMovementMode());
+		}
+	}
+
+	if (MovementMode == MOVE_None)
+	{
+		return;
+	}
+
+	const FVector OldVelocity = Velocity;
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+
+	if (SimulatedLOD == EDashSimulatedMovementLOD::Interpolate)
+	{
+		const int32 NumSnapshots = SimulatedSnapshots.Num();
+		if (NumSnapshots > 0)
+		{
+			// First snapshot received after the displayed time.
+			const float DisplayTime = GetWorld()->GetTimeSeconds() - SimulatedLODInterpolationDelay;
+			int32 Index = 0;
+			while (Index < NumSnapshots && SimulatedSnapshots[Index].Time <= DisplayTime)
+			{
+				Index++;
+			}
+
+			FVector Location = SimulatedSnapshots[FMath::Clamp(Index, 0, NumSnapshots - 1)].Location;
+			FQuat Rotation = SimulatedSnapshots[FMath::Clamp(Index, 0, NumSnapshots - 1)].Rotation;
+
+			if (Index > 0 && Index < NumSnapshots)
+			{
+				const FDashSimulatedSnapshot& From = SimulatedSnapshots[Index - 1];
+				const FDashSimulatedSnapshot& To = SimulatedSnapshots[Index];
+				const float Alpha = FMath::Clamp((DisplayTime - From.Time) / FMath::Max(To.Time - From.Time, KINDA_SMALL_NUMBER), 0.0f, 1.0f);
+
+				Location = FMath::Lerp(From.Location, To.Location, Alpha);
+				Rotation = FQuat::Slerp(From.Rotation, To.Rotation, Alpha);
+			}
+
+			UpdatedComponent->SetWorldLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::None);
+		}
+	}
+	else
+	{
+		// Move without collision, until network updates stop coming.
+		SimulatedLODTimeSinceUpdate += DeltaSeconds;
+		if (bUseCurvedExtrapolation && SimulatedSnapshots.Num() > 0)
+		{
+			// Predict from the last network update so errors don't accumulate.
+			const FDashSimulatedSnapshot& Snapshot = SimulatedSnapshots.Last();
+			FQuat RotationDelta;
+			const FVector Delta = PredictPath(Snapshot.Velocity, FMath::Min(SimulatedLODTimeSinceUpdate, SimulatedLODMaxExtrapolationTime), Velocity, RotationDelta);
+
+			// Keep the capsule standing on the predicted floor.
+			FQuat Rotation = RotationDelta * Snapshot.Rotation;
+			if (!ReplicatedPath.FloorNormal.IsZero())
+			{
+				Rotation = FRotationMatrix::MakeFromZX(RotationDelta.RotateVector(ReplicatedPath.FloorNormal), Rotation.GetAxisX()).ToQuat();
+			}
+
+			UpdatedComponent->SetWorldLocationAndRotation(Snapshot.Location + Delta, Rotation, false, nullptr, ETeleportType::None);
+		}
+		else if (SimulatedLODTimeSinceUpdate <= SimulatedLODMaxExtrapolationTime)
+		{
+			if (MovementMode == MOVE_Falling && !CharacterOwner->bSimGravityDisabled)
+			{
+				Velocity = NewFallVelocity(Velocity, GetGravity(), DeltaSeconds);
+			}
+
+			UpdatedComponent->MoveComponent(Velocity * DeltaSeconds, UpdatedComponent->GetComponentQuat(), false);
+		}
+	}
+
+	OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
+	CallMovementUpdateDelegate(DeltaSeconds, OldLocation, OldVelocity);
+
+	UpdateComponentVelocity();
+
+	LastUpdateLocation = UpdatedComponent->GetComponentLocation();
+	LastUpdateRotation = UpdatedComponent->GetComponentQuat();
+	LastUpdateVelocity = Velocity;
+}
+
+void UDashCharacterMovementComponent::RecordSimulatedLODCost(float DeltaTime, uint32 Cycles)
+{
+	const float Cost = FPlatformTime::ToMilliseconds(Cycles);
+	float& FullTickCost = DashCharacterMovementComponentStatics::SimulatedFullTickCost;
+
+	switch (SimulatedLOD)
+	{
+	case EDashSimulatedMovementLOD::Full:
+		INC_DWORD_STAT(STAT_CharSimulatedLODFull);
+		FullTickCost = FullTickCost > 0.0f ? FMath::Lerp(FullTickCost, Cost, 0.05f) : Cost;
+		return;
+
+	case EDashSimulatedMovementLOD::Extrapolate:
+		INC_DWORD_STAT(STAT_CharSimulatedLODExtrapolate);
+		break;
+
+	default:
+		INC_DWORD_STAT(STAT_CharSimulatedLODInterpolate);
+		break;
+	}
+
+	// A full simulation would have ticked on every frame covered by this tick.
+	const float WorldDeltaSeconds = GetWorld()->GetDeltaSeconds();
+	const float Frames = WorldDeltaSeconds > 0.0f ? FMath::Max(DeltaTime / WorldDeltaSeconds, 1.0f) : 1.0f;
+	const float SavedTime = FMath::Max(FullTickCost * Frames - Cost, 0.0f);
+
+	SimulatedLODSavedTime += SavedTime;
+	INC_FLOAT_STAT_BY(STAT_CharSimulatedLODSaved, SavedTime);
+	CSV_CUSTOM_STAT(DashMovement, SimulatedLODSavedMs, SavedTime, ECsvCustomStatOp::Accumulate);
+}
+
+void UDashCharacterMovementComponent::UpdateReplicatedPath(float DeltaSeconds, const FVector& OldVelocity)
+{
+	FVector AngularVelocity = FVector::ZeroVector;
+	FVector FloorNormal = FVector::ZeroVector;
+
+	// Gravity already describes the path while falling.
+	if (MovementMode != MOVE_Falling && DeltaSeconds > 0.0f)
+	{
+		const FVector OldDirection = OldVelocity.GetSafeNormal();
+		const FVector Direction = Velocity.GetSafeNormal();
+		const FVector Axis = OldDirection ^ Direction;
+		const float SinAngle = Axis.Size();
+
+		if (SinAngle > KINDA_SMALL_NUMBER)
+		{
+			AngularVelocity = Axis * (FMath::Atan2(SinAngle, OldDirection | Direction) / (SinAngle * DeltaSeconds));
+		}
+
+		if (IsMovingOnGround())
+		{
+			FloorNormal = CurrentFloor.HitResult.ImpactNormal;
+		}
+	}
+
+	// Velocity direction changes every tick on curves; only replicate noticeable changes.
+	if ((AngularVelocity - ReplicatedPath.AngularVelocity).SizeSquared() > FMath::Square(FMath::DegreesToRadians(PathReplicationTurnRateThreshold)))
+	{
+		ReplicatedPath.AngularVelocity = AngularVelocity;
+	}
+
+	if (FloorNormal.IsZero() != ReplicatedPath.FloorNormal.IsZero() || (!FloorNormal.IsZero() &&
+		(ReplicatedPath.FloorNormal | FloorNormal) < FMath::Cos(FMath::DegreesToRadians(PathReplicationAngleThreshold))))
+	{
+		ReplicatedPath.FloorNormal = FloorNormal;
+	}
+}
+
+FVector UDashCharacterMovementComponent::PredictPath(const FVector& InVelocity, float Time, FVector& OutVelocity, FQuat& OutRotationDelta) const
+{
+	OutVelocity = InVelocity;
+	OutRotationDelta = FQuat::Identity;
+
+	if (MovementMode == MOVE_Falling)
+	{
+		// Parabola implied by gravity.
+		const FVector Gravity = (CharacterOwner != nullptr && CharacterOwner->bSimGravityDisabled) ? FVector::ZeroVector : GetGravity();
+		OutVelocity = InVelocity + Gravity * Time;
+
+		return InVelocity * Time + Gravity * (0.5f * Time * Time);
+	}
+
+	const float TurnRate = ReplicatedPath.AngularVelocity.Size();
+	if (TurnRate < KINDA_SMALL_NUMBER)
+	{
+		return InVelocity * Time;
+	}
+
+	// Circular arc at constant speed; velocity along the rotation axis is unaffected.
+	const FVector Axis = ReplicatedPath.AngularVelocity / TurnRate;
+	const FVector AxialVelocity = Axis * (InVelocity | Axis);
+	const FVector TurningVelocity = InVelocity - AxialVelocity;
+
+	float SinAngle, CosAngle;
+	FMath::SinCos(&SinAngle, &CosAngle, TurnRate * Time);
+
+	OutRotationDelta = FQuat(Axis, TurnRate * Time);
+	OutVelocity = OutRotationDelta.RotateVector(InVelocity);
+
+	return AxialVelocity * Time + TurningVelocity * (SinAngle / TurnRate) + (Axis ^ TurningVelocity) * ((1.0f - CosAngle) / TurnRate);
+}
+
+void UDashCharacterMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity)
+{
+	Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
+
+	// Still inside the scoped movement update of PerformMovement or SimulateMovement.
+	FlushDeferredRotation();
+
+	// Once per move, so the server also sweeps each move of remote clients replayed by ServerMove.
+	CollectRings(OldLocation, DeltaSeconds);
+
+	if (bUseCurvedExtrapolation && CharacterOwner != nullptr && CharacterOwner->HasAuthority() && GetNetMode() > NM_Standalone)
+	{
+		// Replicate path shape to simulated proxies; left unchanged, it costs no bandwidth.
+		UpdateReplicatedPath(DeltaSeconds, OldVelocity);
+	}
+}
+
+void UDashCharacterMovementComponent::FlushDeferredRotation()
+{
+	if (!bHasDeferredAxisZ && !bHasDeferredRotation)
+	{
+		return;
+	}
+
+	const FQuat CurrentQuat = UpdatedComponent->GetComponentQuat();
+	FQuat NewQuat = bHasDeferredRotation ? DeferredRotation : CurrentQuat;
+
+	// Take desired Z rotation axis of capsule, keep the X rotation axis of the desired facing.
+	if (bHasDeferredAxisZ && (DeferredAxisZ | NewQuat.GetAxisZ()) < THRESH_NORMALS_ARE_PARALLEL)
+	{
+		NewQuat = FRotationMatrix::MakeFromZX(DeferredAxisZ, NewQuat.GetAxisX()).ToQuat();
+	}
+
+	bHasDeferredAxisZ = false;
+	bHasDeferredRotation = false;
+
+	if (CurrentQuat.Equals(NewQuat, KINDA_SMALL_NUMBER))
+	{
+		return;
+	}
+
+	// A capsule turning around its own axis covers the same space; only tilting it can penetrate geometry.
+	const bool bSymmetric = UpdatedPrimitive != nullptr && UpdatedPrimitive->GetCollisionShape().IsCapsule() &&
+		(NewQuat.GetAxisZ() | GetComponentAxisZ()) >= THRESH_NORMALS_ARE_PARALLEL;
+
+	// Intentionally not using MoveUpdatedComponent to bypass constraints.
+	UpdatedComponent->MoveComponent(FVector::ZeroVector, NewQuat, !bSymmetric);
+}
+
+void UDashCharacterMovementComponent::CollectRings(const FVector& StartLocation, float DeltaTime)
+{
+	if (!bCollectRings || RingSubsystem == nullptr || !RingSubsystem->HasActiveRings() || !HasValidData())
+	{
+		return;
+	}
+
+	float Radius, HalfHeight;
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(Radius, HalfHeight);
+
+	// Don't collect along teleports.
+	const FVector EndLocation = UpdatedComponent->GetComponentLocation();
+	const float MaxMoveDistance = FMath::Max(Velocity.Size() * DeltaTime * 2.0f, Radius * 2.0f);
+	const FVector MoveStart = FVector::DistSquared(StartLocation, EndLocation) <= FMath::Square(MaxMoveDistance) ? StartLocation : EndLocation;
+
+	RingSubsystem->CollectRings(CharacterOwner, MoveStart, EndLocation, UpdatedComponent->GetComponentQuat(), Radius, HalfHeight);
+}
+
+void UDashCharacterMovementComponent::RunMicroBenchmark(UWorld* World, int32 Iterations)
+{
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	Iterations = FMath::Max(Iterations, 1);
+	const int32 FrameStateCache = DashCharacterMovementCVars::FrameStateCache;
+
+	for (TObjectIterator<UDashCharacterMovementComponent> It; It; ++It)
+	{
+		UDashCharacterMovementComponent* Component = *It;
+		if (Component->GetWorld() != World || !Component->HasValidData())
+		{
+			continue;
+		}
+
+		// Cost of one gravity or axis query without and with the frame state, in nanoseconds.
+		double QueryCost[2];
+		for (int32 bCached = 0; bCached < 2; ++bCached)
+		{
+			DashCharacterMovementCVars::FrameStateCache = bCached;
+			Component->FrameState.Invalidate();
+
+			FVector Sum = FVector::ZeroVector;
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Index = 0; Index < Iterations; ++Index)
+			{
+				Sum += Component->GetGravity();
+				Sum += Component->GetGravityDirection(false);
+				Sum += Component->GetGravityDirection(true);
+				Sum += Component->GetComponentAxisX();
+				Sum += Component->GetComponentAxisZ();
+			}
+
+			QueryCost[bCached] = (FPlatformTime::Seconds() - StartTime) * 1.0e9 / (Iterations * 5.0);
+
+			// Use the results so the queries can't be optimized out.
+			UE_CLOG(Sum.ContainsNaN(), LogCharacterMovement, Warning, TEXT("%s: NaN gravity or axes."), *Component->GetName());
+		}
+
+		UE_LOG(LogCharacterMovement, Display, TEXT("%s: gravity/axis query %.1f ns uncached, %.1f ns cached; %d queries last tick, ~%.2f us saved per tick."),
+			*GetNameSafe(Component->GetOwner()), QueryCost[0], QueryCost[1], Component->LastNumFrameStateQueries,
+			(QueryCost[0] - QueryCost[1]) * Component->LastNumFrameStateQueries / 1000.0);
+
+		// Cost of one constrained rotation step with Euler round trips, as PhysicsRotation used to do, and quaternion-only, in nanoseconds.
+		const FQuat CurrentQuat = Component->UpdatedComponent->GetComponentQuat();
+		const FQuat DesiredQuat = FQuat(Component->GetComponentAxisZ(), 0.5f) * CurrentQuat;
+		const FVector CapsuleUp = Component->GetComponentAxisZ();
+
+		FQuat Sum(0.0f, 0.0f, 0.0f, 0.0f);
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Iterations; ++Index)
+		{
+			const FRotator CurrentRotation = CurrentQuat.Rotator();
+			const FRotator DesiredRotation = FRotationMatrix::MakeFromZX(CapsuleUp, DesiredQuat.Rotator().Vector()).Rotator();
+			Sum += FQuat::Slerp(FQuat(CurrentRotation), FQuat(DesiredRotation), 0.1f);
+		}
+
+		const double EulerCost = (FPlatformTime::Seconds() - StartTime) * 1.0e9 / Iterations;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Iterations; ++Index)
+		{
+			Sum += FQuat::Slerp(CurrentQuat, FRotationMatrix::MakeFromZX(CapsuleUp, DesiredQuat.GetAxisX()).ToQuat(), 0.1f);
+		}
+
+		const double QuatCost = (FPlatformTime::Seconds() - StartTime) * 1.0e9 / Iterations;
+
+		UE_CLOG(Sum.ContainsNaN(), LogCharacterMovement, Warning, TEXT("%s: NaN rotation."), *Component->GetName());
+		UE_LOG(LogCharacterMovement, Display, TEXT("%s: rotation step %.1f ns with Euler round trips, %.1f ns quaternion-only."),
+			*GetNameSafe(Component->GetOwner()), EulerCost, QuatCost);
+	}
+
+	DashCharacterMovementCVars::FrameStateCache = FrameStateCache;
+}
+
+FSavedMove_DashCharacter::FSavedMove_DashCharacter()
+	: SavedCustomGravityDirection(FVector::ZeroVector), SavedGravityPoint(FVector::ZeroVector), SavedGravityScale(1.0f)
+{
+}
+
+void FSavedMove_DashCharacter::Clear()
+{
+	Super::Clear();
+
+	SavedCustomGravityDirection = FVector::ZeroVector;
+	SavedGravityPoint = FVector::ZeroVector;
+	SavedGravityScale = 1.0f;
+}
+
+void FSavedMove_DashCharacter::SetInitialPosition(ACharacter* C)
+{
+	Super::SetInitialPosition(C);
+
+	const UDashCharacterMovementComponent* MovementComponent = Cast<UDashCharacterMovementComponent>(C->GetCharacterMovement());
+	if (MovementComponent != nullptr)
+	{
+		SavedCustomGravityDirection = MovementComponent->CustomGravityDirection;
+		SavedGravityPoint = MovementComponent->GravityPoint;
+		SavedGravityScale = MovementComponent->GravityScale;
+	}
+}
+
+void FSavedMove_DashCharacter::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	// Replay with the gravity that applied to the move.
+	UDashCharacterMovementComponent* MovementComponent = Cast<UDashCharacterMovementComponent>(C->GetCharacterMovement());
+	if (MovementComponent != nullptr && DashCharacterMovementCVars::NetSaveGravityInMoves != 0)
+	{
+		MovementComponent->SetCustomGravityDirection(SavedCustomGravityDirection);
+		MovementComponent->GravityPoint = SavedGravityPoint;
+		MovementComponent->GravityScale = SavedGravityScale;
+	}
+}
+
+bool FSavedMove_DashCharacter::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	if (DashCharacterMovementCVars::NetSaveGravityInMoves != 0)
+	{
+		const FSavedMove_DashCharacter* NewDashMove = static_cast<const FSavedMove_DashCharacter*>(NewMove.Get());
+		if (SavedCustomGravityDirection != NewDashMove->SavedCustomGravityDirection || SavedGravityPoint != NewDashMove->SavedGravityPoint ||
+			SavedGravityScale != NewDashMove->SavedGravityScale)
+		{
+			return false;
+		}
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+FNetworkPredictionData_Client_DashCharacter::FNetworkPredictionData_Client_DashCharacter(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_DashCharacter::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_DashCharacter());
 }
@@ -0,0 +1,689 @@
+////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2019 GalaxySoftware Studio
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#include "DashCollisionSDF.h"
+#include "DashEngine.h"
+
+#include "EngineUtils.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "Components/PrimitiveComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Async/ParallelFor.h"
+#include "Misc/PackageName.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDashCollisionSDF, Log, All);
+
+DECLARE_CYCLE_STAT(TEXT("Dash Collision SDF Sweep"), STAT_DashCollisionSDFSweep, STATGROUP_Character);
+
+// Statics.
+namespace DashCollisionSDFStatics
+{
+	// Sphere tracing stops once the sphere is this close to collision.
+	static const float HitTolerance = 0.01f;
+
+	// Sphere tracing gives up after this many steps and reports a hit where it stopped.
+	static const int32 MaxTraceSteps = 64;
+
+	// Largest quantized distance.
+	static const float MaxSample = 65535.0f;
+
+	// Samples of a voxel are linear if the differences along each axis agree within this many quantization steps.
+	static const float PlanarSampleTolerance = 2.0f;
+
+	// Minimum dot product of the normals of a flat surface on both ends of a planar hit.
+	static const float PlanarNormalTolerance = 0.999f;
+
+	// Component index of samples far from collision.
+	static const uint16 NoComponent = MAX_uint16;
+
+	// Suffix of the distance field package of a map.
+	static const TCHAR* PackageSuffix = TEXT("_CollisionSDF");
+}
+
+
+UDashCollisionSDF::UDashCollisionSDF()
+{
+	CollisionChannel = ECC_Pawn;
+	Origin = FVector::ZeroVector;
+	VoxelSize = 20.0f;
+	BrickSize = 8;
+	MaxDistance = VoxelSize * BrickSize;
+	NumBricks = FIntVector::ZeroValue;
+}
+
+bool UDashCollisionSDF::HasData() const
+{
+	return BrickTable.Num() > 0 && BrickTable.Num() == NumBricks.X * NumBricks.Y * NumBricks.Z && SampleComponents.Num() == BrickSamples.Num();
+}
+
+int32 UDashCollisionSDF::GetBrickIndex(const FVector& VoxelLocation, FIntVector& OutBrick) const
+{
+	OutBrick = FIntVector(FMath::FloorToInt(VoxelLocation.X) / BrickSize, FMath::FloorToInt(VoxelLocation.Y) / BrickSize, FMath::FloorToInt(VoxelLocation.Z) / BrickSize);
+
+	// The far side of the last brick still belongs to it.
+	OutBrick.X = FMath::Min(OutBrick.X, NumBricks.X - 1);
+	OutBrick.Y = FMath::Min(OutBrick.Y, NumBricks.Y - 1);
+	OutBrick.Z = FMath::Min(OutBrick.Z, NumBricks.Z - 1);
+
+	if (VoxelLocation.X < 0.0f || VoxelLocation.Y < 0.0f || VoxelLocation.Z < 0.0f ||
+		VoxelLocation.X > NumBricks.X * BrickSize || VoxelLocation.Y > NumBricks.Y * BrickSize || VoxelLocation.Z > NumBricks.Z * BrickSize)
+	{
+		return INDEX_NONE;
+	}
+
+	return (OutBrick.Z * NumBricks.Y + OutBrick.Y) * NumBricks.X + OutBrick.X;
+}
+
+float UDashCollisionSDF::GetDistance(const FVector& Location) const
+{
+	const FVector VoxelLocation = (Location - Origin) / VoxelSize;
+
+	FIntVector Brick;
+	const int32 BrickIndex = GetBrickIndex(VoxelLocation, Brick);
+
+	// The field covers collision plus a brick on each side, so outside of it is far from everything.
+	if (BrickIndex == INDEX_NONE)
+	{
+		return MaxDistance;
+	}
+
+	const int32 SampleBrick = BrickTable[BrickIndex];
+	if (SampleBrick == INDEX_NONE)
+	{
+		// Collision may slip between the samples of a far brick; a voxel of margin keeps sphere tracing from stepping over it.
+		return MaxDistance - VoxelSize;
+	}
+
+	const FVector Local = VoxelLocation - FVector(Brick * BrickSize);
+	const int32 X = FMath::Clamp(FMath::FloorToInt(Local.X), 0, BrickSize - 1);
+	const int32 Y = FMath::Clamp(FMath::FloorToInt(Local.Y), 0, BrickSize - 1);
+	const int32 Z = FMath::Clamp(FMath::FloorToInt(Local.Z), 0, BrickSize - 1);
+	const float AlphaX = FMath::Clamp(Local.X - X, 0.0f, 1.0f);
+	const float AlphaY = FMath::Clamp(Local.Y - Y, 0.0f, 1.0f);
+	const float AlphaZ = FMath::Clamp(Local.Z - Z, 0.0f, 1.0f);
+
+	const int32 Stride = BrickSize + 1;
+	const uint16* Samples = &BrickSamples[SampleBrick * Stride * Stride * Stride + (Z * Stride + Y) * Stride + X];
+	const int32 StrideY = Stride;
+	const int32 StrideZ = Stride * Stride;
+
+	// Trilinear interpolation of the 8 samples around the location.
+	const float Sample00 = FMath::Lerp<float>(Samples[0], Samples[1], AlphaX);
+	const float Sample10 = FMath::Lerp<float>(Samples[StrideY], Samples[StrideY + 1], AlphaX);
+	const float Sample01 = FMath::Lerp<float>(Samples[StrideZ], Samples[StrideZ + 1], AlphaX);
+	const float Sample11 = FMath::Lerp<float>(Samples[StrideZ + StrideY], Samples[StrideZ + StrideY + 1], AlphaX);
+	const float Sample = FMath::Lerp(FMath::Lerp(Sample00, Sample10, AlphaY), FMath::Lerp(Sample01, Sample11, AlphaY), AlphaZ);
+
+	return Sample * (MaxDistance / DashCollisionSDFStatics::MaxSample);
+}
+
+FVector UDashCollisionSDF::GetGradient(const FVector& Location) const
+{
+	const float Step = VoxelSize * 0.5f;
+
+	const FVector Gradient(
+		GetDistance(Location + FVector(Step, 0.0f, 0.0f)) - GetDistance(Location - FVector(Step, 0.0f, 0.0f)),
+		GetDistance(Location + FVector(0.0f, Step, 0.0f)) - GetDistance(Location - FVector(0.0f, Step, 0.0f)),
+		GetDistance(Location + FVector(0.0f, 0.0f, Step)) - GetDistance(Location - FVector(0.0f, 0.0f, Step)));
+
+	return Gradient.GetSafeNormal();
+}
+
+bool UDashCollisionSDF::SphereTrace(const FVector& Start, const FVector& End, float Radius, float& OutTime, bool& bOutStartPenetrating) const
+{
+	OutTime = 1.0f;
+	bOutStartPenetrating = false;
+
+	const FVector Delta = End - Start;
+	const float Length = Delta.Size();
+	const FVector Direction = Length > KINDA_SMALL_NUMBER ? Delta / Length : FVector::ZeroVector;
+
+	// March by the clearance around the sphere, which can't skip over collision.
+	float Distance = 0.0f;
+	for (int32 Step = 0; Step < DashCollisionSDFStatics::MaxTraceSteps; Step++)
+	{
+		const float Clearance = GetDistance(Start + Direction * Distance) - Radius;
+		if (Clearance <= DashCollisionSDFStatics::HitTolerance)
+		{
+			bOutStartPenetrating = Distance == 0.0f && Clearance < -DashCollisionSDFStatics::HitTolerance;
+			OutTime = Length > KINDA_SMALL_NUMBER ? Distance / Length : 0.0f;
+			return true;
+		}
+
+		if (Distance >= Length)
+		{
+			return false;
+		}
+
+		Distance = FMath::Min(Distance + Clearance, Length);
+	}
+
+	// Still closing in on collision; the trace can't be proven clear.
+	OutTime = Length > KINDA_SMALL_NUMBER ? Distance / Length : 0.0f;
+	return true;
+}
+
+int32 UDashCollisionSDF::GetComponentIndex(const FVector& Location) const
+{
+	const FVector VoxelLocation = (Location - Origin) / VoxelSize;
+
+	FIntVector Brick;
+	const int32 BrickIndex = GetBrickIndex(VoxelLocation, Brick);
+	if (BrickIndex == INDEX_NONE || BrickTable[BrickIndex] == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+
+	const FVector Local = VoxelLocation - FVector(Brick * BrickSize);
+	const int32 X = FMath::Clamp(FMath::FloorToInt(Local.X), 0, BrickSize - 1);
+	const int32 Y = FMath::Clamp(FMath::FloorToInt(Local.Y), 0, BrickSize - 1);
+	const int32 Z = FMath::Clamp(FMath::FloorToInt(Local.Z), 0, BrickSize - 1);
+
+	const int32 Stride = BrickSize + 1;
+	const int32 FirstSample = BrickTable[BrickIndex] * Stride * Stride * Stride + (Z * Stride + Y) * Stride + X;
+
+	// Component of the corner of the voxel closest to collision.
+	int32 ComponentIndex = INDEX_NONE;
+	uint16 ClosestSample = MAX_uint16;
+	for (int32 Corner = 0; Corner < 8; Corner++)
+	{
+		const int32 Sample = FirstSample + (Corner >> 2) * Stride * Stride + ((Corner >> 1) & 1) * Stride + (Corner & 1);
+		if (SampleComponents[Sample] != DashCollisionSDFStatics::NoComponent && (ComponentIndex == INDEX_NONE || BrickSamples[Sample] < ClosestSample))
+		{
+			ComponentIndex = SampleComponents[Sample];
+			ClosestSample = BrickSamples[Sample];
+		}
+	}
+
+	return ComponentIndex;
+}
+
+float UDashCollisionSDF::GetErrorBound() const
+{
+	return VoxelSize * HALF_SQRT_3 + MaxDistance / DashCollisionSDFStatics::MaxSample;
+}
+
+bool UDashCollisionSDF::GetPlanarDistance(const FVector& Location, float& OutDistance, FVector& OutNormal) const
+{
+	const FVector VoxelLocation = (Location - Origin) / VoxelSize;
+
+	FIntVector Brick;
+	const int32 BrickIndex = GetBrickIndex(VoxelLocation, Brick);
+	if (BrickIndex == INDEX_NONE || BrickTable[BrickIndex] == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const FVector Local = VoxelLocation - FVector(Brick * BrickSize);
+	const int32 X = FMath::Clamp(FMath::FloorToInt(Local.X), 0, BrickSize - 1);
+	const int32 Y = FMath::Clamp(FMath::FloorToInt(Local.Y), 0, BrickSize - 1);
+	const int32 Z = FMath::Clamp(FMath::FloorToInt(Local.Z), 0, BrickSize - 1);
+
+	const int32 Stride = BrickSize + 1;
+	const uint16* Samples = &BrickSamples[BrickTable[BrickIndex] * Stride * Stride * Stride + (Z * Stride + Y) * Stride + X];
+	const int32 StrideY = Stride;
+	const int32 StrideZ = Stride * Stride;
+
+	const float S000 = Samples[0];
+	const float S100 = Samples[1];
+	const float S010 = Samples[StrideY];
+	const float S110 = Samples[StrideY + 1];
+	const float S001 = Samples[StrideZ];
+	const float S101 = Samples[StrideZ + 1];
+	const float S011 = Samples[StrideZ + StrideY];
+	const float S111 = Samples[StrideZ + StrideY + 1];
+
+	// Unsigned distances fold at zero, inside collision.
+	if (FMath::Min3(FMath::Min(S000, S100), FMath::Min(S010, S110), FMath::Min3(FMath::Min(S001, S101), S011, S111)) <= 0.0f)
+	{
+		return false;
+	}
+
+	// The distance to a plane is linear, so the four edges of the voxel along each axis differ by the same amount.
+	const auto GetSlope = [](float A, float B, float C, float D, float& OutSlope)
+	{
+		OutSlope = (A + B + C + D) * 0.25f;
+		return FMath::Max(FMath::Max(A, B), FMath::Max(C, D)) - FMath::Min(FMath::Min(A, B), FMath::Min(C, D)) <= DashCollisionSDFStatics::PlanarSampleTolerance;
+	};
+
+	FVector Slope;
+	if (!GetSlope(S100 - S000, S110 - S010, S101 - S001, S111 - S011, Slope.X) ||
+		!GetSlope(S010 - S000, S110 - S100, S011 - S001, S111 - S101, Slope.Y) ||
+		!GetSlope(S001 - S000, S101 - S100, S011 - S010, S111 - S110, Slope.Z))
+	{
+		return false;
+	}
+
+	// Distance fields have a unit gradient wherever they're linear.
+	const FVector Gradient = Slope * (MaxDistance / DashCollisionSDFStatics::MaxSample / VoxelSize);
+	const float GradientSize = Gradient.Size();
+	if (FMath::Abs(GradientSize - 1.0f) > 1.0f - DashCollisionSDFStatics::PlanarNormalTolerance)
+	{
+		return false;
+	}
+
+	OutDistance = GetDistance(Location);
+	OutNormal = Gradient / GradientSize;
+	return true;
+}
+
+bool UDashCollisionSDF::GetPlanarHit(const FVector& Start, const FVector& End, float Radius, float StartTime, float& OutTime, FVector& OutNormal) const
+{
+	const FVector Delta = End - Start;
+	const FVector ClearLocation = Start + Delta * StartTime;
+
+	float Distance;
+	FVector Normal;
+	if (!GetPlanarDistance(ClearLocation, Distance, Normal) || Distance < Radius)
+	{
+		return false;
+	}
+
+	// Along a linear field, the clearance shrinks with the approach toward the surface.
+	const float Approach = -(Delta | Normal);
+	if (Approach <= KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	const float Time = StartTime + (Distance - Radius) / Approach;
+	if (Time > 1.0f || (Time - StartTime) * Delta.Size() > VoxelSize)
+	{
+		return false;
+	}
+
+	// The sphere must touch the same surface, and the field must still be linear where it does.
+	float HitDistance;
+	FVector HitNormal;
+	const float SampleTolerance = DashCollisionSDFStatics::PlanarSampleTolerance * MaxDistance / DashCollisionSDFStatics::MaxSample;
+	if (!GetPlanarDistance(Start + Delta * Time, HitDistance, HitNormal) || (HitNormal | Normal) < DashCollisionSDFStatics::PlanarNormalTolerance ||
+		FMath::Abs(HitDistance - Radius) > SampleTolerance)
+	{
+		return false;
+	}
+
+	OutTime = Time;
+	OutNormal = HitNormal;
+	return true;
+}
+
+bool UDashCollisionSDF::IsNearUnbakedCollision(const FBox& Box) const
+{
+	if (UnbakedBricks.Num() == 0)
+	{
+		return false;
+	}
+
+	// Bricks outside of the grid are far from every component, baked or not.
+	const FVector Min = (Box.Min - Origin) / MaxDistance;
+	const FVector Max = (Box.Max - Origin) / MaxDistance;
+	const FIntVector MinBrick(FMath::Max(FMath::FloorToInt(Min.X), 0), FMath::Max(FMath::FloorToInt(Min.Y), 0), FMath::Max(FMath::FloorToInt(Min.Z), 0));
+	const FIntVector MaxBrick(FMath::Min(FMath::FloorToInt(Max.X), NumBricks.X - 1), FMath::Min(FMath::FloorToInt(Max.Y), NumBricks.Y - 1),
+		FMath::Min(FMath::FloorToInt(Max.Z), NumBricks.Z - 1));
+
+	for (int32 Z = MinBrick.Z; Z <= MaxBrick.Z; Z++)
+	{
+		for (int32 Y = MinBrick.Y; Y <= MaxBrick.Y; Y++)
+		{
+			for (int32 X = MinBrick.X; X <= MaxBrick.X; X++)
+			{
+				if (UnbakedBricks[(Z * NumBricks.Y + Y) * NumBricks.X + X])
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+#if WITH_EDITOR
+void UDashCollisionSDF::Build(UWorld* World, ECollisionChannel InCollisionChannel, float InVoxelSize, int32 InBrickSize)
+{
+	CollisionChannel = InCollisionChannel;
+	VoxelSize = FMath::Max(InVoxelSize, 1.0f);
+	BrickSize = FMath::Clamp(InBrickSize, 2, 32);
+	MaxDistance = VoxelSize * BrickSize;
+	NumBricks = FIntVector::ZeroValue;
+	Components.Reset();
+	BrickTable.Reset();
+	BrickSamples.Reset();
+	SampleComponents.Reset();
+	UnbakedBricks.Reset();
+
+	// Only static components; stationary and movable ones are dynamic for physics queries and stay there.
+	TArray<UPrimitiveComponent*> Primitives;
+	TArray<FBox> UnbakedBounds;
+	FBox Bounds(ForceInit);
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		if (It->GetLevel() != World->PersistentLevel)
+		{
+			continue;
+		}
+
+		TInlineComponentArray<UPrimitiveComponent*> ActorPrimitives(*It);
+		for (UPrimitiveComponent* Primitive : ActorPrimitives)
+		{
+			if (Primitive->Mobility != EComponentMobility::Static || !Primitive->IsPhysicsStateCreated() || !Primitive->IsQueryCollisionEnabled() ||
+				Primitive->GetCollisionResponseToChannel(CollisionChannel) != ECR_Block)
+			{
+				continue;
+			}
+
+			// Distances can't be measured to triangle meshes and heightfields; those stay in the physics scene only.
+			const FBox PrimitiveBounds = Primitive->Bounds.GetBox();
+			const UBodySetup* BodySetup = Primitive->GetBodySetup();
+			FVector ClosestPoint;
+			if ((BodySetup != nullptr && BodySetup->GetCollisionTraceFlag() == CTF_UseComplexAsSimple) ||
+				Primitive->GetDistanceToCollision(PrimitiveBounds.Max + FVector(VoxelSize), ClosestPoint) < 0.0f)
+			{
+				UE_LOG(LogDashCollisionSDF, Warning, TEXT("Can't sample %s.%s of %s; floor checks near it use the physics scene."),
+					*It->GetName(), *Primitive->GetName(), *World->GetMapName());
+
+				UnbakedBounds.Add(PrimitiveBounds);
+				Bounds += PrimitiveBounds;
+				continue;
+			}
+
+			FDashCollisionSDFComponent& Component = Components.AddDefaulted_GetRef();
+			Component.ActorName = It->GetFName();
+			Component.ComponentName = Primitive->GetFName();
+
+			Primitives.Add(Primitive);
+			Bounds += PrimitiveBounds;
+		}
+	}
+
+	// The last index marks samples far from collision.
+	if (Primitives.Num() == 0 || Primitives.Num() >= DashCollisionSDFStatics::NoComponent)
+	{
+		UE_LOG(LogDashCollisionSDF, Error, TEXT("Can't bake %d components of %s."), Primitives.Num(), *World->GetMapName());
+		Components.Reset();
+		return;
+	}
+
+	Bounds = Bounds.ExpandBy(MaxDistance);
+	Origin = Bounds.Min;
+
+	const FVector Size = Bounds.GetSize();
+	NumBricks = FIntVector(FMath::CeilToInt(Size.X / MaxDistance), FMath::CeilToInt(Size.Y / MaxDistance), FMath::CeilToInt(Size.Z / MaxDistance));
+
+	const int32 TotalBricks = NumBricks.X * NumBricks.Y * NumBricks.Z;
+	const int32 Stride = BrickSize + 1;
+	const int32 SamplesPerBrick = Stride * Stride * Stride;
+
+	// Bake every brick in parallel, then keep those close to collision.
+	TArray<TArray<uint16>> BakedSamples;
+	TArray<TArray<uint16>> BakedComponents;
+	BakedSamples.SetNum(TotalBricks);
+	BakedComponents.SetNum(TotalBricks);
+
+	if (UnbakedBounds.Num() > 0)
+	{
+		UnbakedBricks.Init(false, TotalBricks);
+	}
+
+	ParallelFor(TotalBricks, [&](int32 BrickIndex)
+	{
+		const FIntVector Brick(BrickIndex % NumBricks.X, (BrickIndex / NumBricks.X) % NumBricks.Y, BrickIndex / (NumBricks.X * NumBricks.Y));
+		const FVector BrickMin = Origin + FVector(Brick) * MaxDistance;
+		const FBox SearchBox = FBox(BrickMin, BrickMin + FVector(MaxDistance)).ExpandBy(MaxDistance);
+
+		for (const FBox& Box : UnbakedBounds)
+		{
+			if (Box.Intersect(SearchBox))
+			{
+				UnbakedBricks[BrickIndex] = true;
+				break;
+			}
+		}
+
+		TArray<int32, TInlineAllocator<16>> Candidates;
+		for (int32 Index = 0; Index < Primitives.Num(); Index++)
+		{
+			if (Primitives[Index]->Bounds.GetBox().Intersect(SearchBox))
+			{
+				Candidates.Add(Index);
+			}
+		}
+
+		if (Candidates.Num() == 0)
+		{
+			return;
+		}
+
+		TArray<uint16> Samples;
+		TArray<uint16> Closests;
+		Samples.SetNumUninitialized(SamplesPerBrick);
+		Closests.SetNumUninitialized(SamplesPerBrick);
+		bool bNearCollision = false;
+
+		for (int32 Z = 0; Z < Stride; Z++)
+		{
+			for (int32 Y = 0; Y < Stride; Y++)
+			{
+				for (int32 X = 0; X < Stride; X++)
+				{
+					const FVector Location = BrickMin + FVector(X, Y, Z) * VoxelSize;
+					float Distance = MaxDistance;
+					int32 Closest = INDEX_NONE;
+
+					for (int32 Index = 0; Index < Candidates.Num(); Index++)
+					{
+						FVector ClosestPoint;
+						const float CandidateDistance = Primitives[Candidates[Index]]->GetDistanceToCollision(Location, ClosestPoint);
+						if (CandidateDistance >= 0.0f && CandidateDistance < Distance)
+						{
+							Distance = CandidateDistance;
+							Closest = Candidates[Index];
+						}
+					}
+
+					const int32 Sample = (Z * Stride + Y) * Stride + X;
+					Samples[Sample] = (uint16)FMath::Clamp(FMath::RoundToInt(Distance / MaxDistance * DashCollisionSDFStatics::MaxSample), 0, MAX_uint16);
+					Closests[Sample] = Closest != INDEX_NONE ? (uint16)Closest : DashCollisionSDFStatics::NoComponent;
+					bNearCollision |= Closest != INDEX_NONE;
+				}
+			}
+		}
+
+		if (bNearCollision)
+		{
+			BakedSamples[BrickIndex] = MoveTemp(Samples);
+			BakedComponents[BrickIndex] = MoveTemp(Closests);
+		}
+	});
+
+	BrickTable.Init(INDEX_NONE, TotalBricks);
+	int32 NumStoredBricks = 0;
+	for (int32 BrickIndex = 0; BrickIndex < TotalBricks; BrickIndex++)
+	{
+		if (BakedSamples[BrickIndex].Num() > 0)
+		{
+			BrickTable[BrickIndex] = NumStoredBricks++;
+			BrickSamples.Append(BakedSamples[BrickIndex]);
+			SampleComponents.Append(BakedComponents[BrickIndex]);
+		}
+	}
+
+	UE_LOG(LogDashCollisionSDF, Log, TEXT("Baked %d components of %s into %d of %d bricks (%.1f MB), within %.1f units; %d components can't be sampled."),
+		Components.Num(), *World->GetMapName(), NumStoredBricks, TotalBricks, (BrickSamples.Num() + SampleComponents.Num()) * sizeof(uint16) / (1024.0f * 1024.0f),
+		GetErrorBound(), UnbakedBounds.Num());
+}
+#endif
+
+UDashCollisionSDF* UDashCollisionSDFSubsystem::LoadCollisionSDF()
+{
+	if (bLoadAttempted)
+	{
+		return CollisionSDF;
+	}
+
+	bLoadAttempted = true;
+
+	UWorld* World = GetWorld();
+	if (World == nullptr || World->PersistentLevel == nullptr)
+	{
+		return nullptr;
+	}
+
+	const FString PackageName = GetCollisionSDFPackageName(World->PersistentLevel->GetOutermost()->GetName());
+	if (!FPackageName::DoesPackageExist(PackageName))
+	{
+		UE_LOG(LogDashCollisionSDF, Verbose, TEXT("%s has no collision SDF."), *World->GetMapName());
+		return nullptr;
+	}
+
+	CollisionSDF = LoadObject<UDashCollisionSDF>(nullptr, *(PackageName + TEXT(".") + FPackageName::GetShortName(PackageName)));
+	if (CollisionSDF == nullptr || !CollisionSDF->HasData())
+	{
+		UE_LOG(LogDashCollisionSDF, Warning, TEXT("Collision SDF %s is missing or empty; bake it again."), *PackageName);
+		CollisionSDF = nullptr;
+		return nullptr;
+	}
+
+	// Find the baked components in this instance of the map.
+	TMap<FName, AActor*> Actors;
+	for (AActor* Actor : World->PersistentLevel->Actors)
+	{
+		if (Actor != nullptr)
+		{
+			Actors.Add(Actor->GetFName(), Actor);
+		}
+	}
+
+	int32 NumMissing = 0;
+	Components.SetNumZeroed(CollisionSDF->Components.Num());
+	for (int32 Index = 0; Index < Components.Num(); Index++)
+	{
+		AActor* const* Actor = Actors.Find(CollisionSDF->Components[Index].ActorName);
+		if (Actor != nullptr)
+		{
+			TInlineComponentArray<UPrimitiveComponent*> ActorPrimitives(*Actor);
+			for (UPrimitiveComponent* Primitive : ActorPrimitives)
+			{
+				if (Primitive->GetFName() == CollisionSDF->Components[Index].ComponentName)
+				{
+					Components[Index] = Primitive;
+					break;
+				}
+			}
+		}
+
+		if (Components[Index] == nullptr)
+		{
+			NumMissing++;
+		}
+	}
+
+	// Hits on missing components have no component, so the SDF is likely out of date.
+	if (NumMissing > 0)
+	{
+		UE_LOG(LogDashCollisionSDF, Warning, TEXT("%d components baked in %s are missing from %s; bake it again."), NumMissing, *PackageName, *World->GetMapName());
+	}
+
+	return CollisionSDF;
+}
+
+bool UDashCollisionSDFSubsystem::SweepSphere(FHitResult& OutHit, const FVector& Start, const FVector& End, float Radius) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_DashCollisionSDFSweep);
+
+	OutHit = FHitResult(1.0f);
+	OutHit.TraceStart = Start;
+	OutHit.TraceEnd = End;
+
+	float Time = 1.0f;
+	bool bStartPenetrating = false;
+	if (CollisionSDF == nullptr || !CollisionSDF->SphereTrace(Start, End, Radius, Time, bStartPenetrating))
+	{
+		return false;
+	}
+
+	const FVector Location = Start + (End - Start) * Time;
+	const FVector Normal = CollisionSDF->GetGradient(Location);
+
+	OutHit.bBlockingHit = true;
+	OutHit.bStartPenetrating = bStartPenetrating;
+	OutHit.Time = Time;
+	OutHit.Distance = (Location - Start).Size();
+	OutHit.Location = Location;
+	OutHit.ImpactPoint = Location - Normal * FMath::Min(CollisionSDF->GetDistance(Location), Radius);
+	OutHit.Normal = Normal;
+	OutHit.ImpactNormal = Normal;
+
+	const int32 ComponentIndex = CollisionSDF->GetComponentIndex(OutHit.ImpactPoint);
+	if (Components.IsValidIndex(ComponentIndex) && Components[ComponentIndex] != nullptr)
+	{
+		OutHit.Component = Components[ComponentIndex];
+		OutHit.Actor = Components[ComponentIndex]->GetOwner();
+	}
+
+	return true;
+}
+
+bool UDashCollisionSDFSubsystem::SweepSpherePlanar(FHitResult& OutHit, const FVector& Start, const FVector& End, float Radius, float StartTime) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_DashCollisionSDFSweep);
+
+	OutHit = FHitResult(1.0f);
+	OutHit.TraceStart = Start;
+	OutHit.TraceEnd = End;
+
+	float Time = 1.0f;
+	FVector Normal;
+	if (CollisionSDF == nullptr || !CollisionSDF->GetPlanarHit(Start, End, Radius, StartTime, Time, Normal))
+	{
+		return false;
+	}
+
+	const FVector Location = Start + (End - Start) * Time;
+	const FVector ImpactPoint = Location - Normal * Radius;
+
+	// Floors need the component they belong to, e.g. to be based on it.
+	const int32 ComponentIndex = CollisionSDF->GetComponentIndex(ImpactPoint);
+	if (!Components.IsValidIndex(ComponentIndex) || Components[ComponentIndex] == nullptr)
+	{
+		return false;
+	}
+
+	OutHit.bBlockingHit = true;
+	OutHit.Time = Time;
+	OutHit.Distance = (Location - Start).Size();
+	OutHit.Location = Location;
+	OutHit.ImpactPoint = ImpactPoint;
+	OutHit.Normal = Normal;
+	OutHit.ImpactNormal = Normal;
+	OutHit.Component = Components[ComponentIndex];
+	OutHit.Actor = Components[ComponentIndex]->GetOwner();
+
+	return true;
+}
+
+FString UDashCollisionSDFSubsystem::GetCollisionSDFPackageName(const FString& MapPackageName)
+{
+	return UWorld::RemovePIEPrefix(MapPackageName) + DashCollisionSDFStatics::PackageSuffix;
+}
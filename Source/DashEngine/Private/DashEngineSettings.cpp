@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2019 GalaxySoftware Studio
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#include "DashEngineSettings.h"
+#include "DashEngine.h"
+
+
+UDashEngineSettings::UDashEngineSettings()
+{
+	CategoryName = TEXT("Game");
+	SectionName = TEXT("DashEngine");
+
+	MaxPooledActorsPerClass = 64;
+	SoundPoolWarmUp = 16;
+	MaxPooledFXComponents = 32;
+
+	SignificanceLookaheadTime = 1.0f;
+	SignificanceBehindDistanceScale = 2.0f;
+	SignificanceOffscreenDistanceScale = 2.0f;
+
+	// Lower levels reach lower tiers sooner and update them less often.
+	struct FLevelDefaults
+	{
+		float DistanceScale;
+		float TickIntervalScale;
+		EDashSignificance FXCullSignificance;
+	};
+
+	static const FLevelDefaults LevelDefaults[] =
+	{
+		{ 0.5f, 2.0f, EDashSignificance::Minimal },
+		{ 0.75f, 1.5f, EDashSignificance::Dormant },
+		{ 1.0f, 1.0f, EDashSignificance::Dormant },
+		{ 1.5f, 1.0f, EDashSignificance::Dormant },
+		{ 2.5f, 0.5f, EDashSignificance::Dormant }
+	};
+
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(LevelDefaults); ++Index)
+	{
+		FDashSignificanceLevel& SignificanceLevel = SignificanceLevels.AddDefaulted_GetRef();
+		SignificanceLevel.Level = (EDashScalabilityLevel)Index;
+		SignificanceLevel.ReducedDistance = 4000.0f * LevelDefaults[Index].DistanceScale;
+		SignificanceLevel.MinimalDistance = 8000.0f * LevelDefaults[Index].DistanceScale;
+		SignificanceLevel.DormantDistance = 16000.0f * LevelDefaults[Index].DistanceScale;
+		SignificanceLevel.ReducedTickInterval = 0.033f * LevelDefaults[Index].TickIntervalScale;
+		SignificanceLevel.MinimalTickInterval = 0.1f * LevelDefaults[Index].TickIntervalScale;
+		SignificanceLevel.DormantTickInterval = 0.5f * LevelDefaults[Index].TickIntervalScale;
+		SignificanceLevel.FXCullSignificance = LevelDefaults[Index].FXCullSignificance;
+	}
+}
+
+const FDashSignificanceLevel* UDashEngineSettings::GetSignificanceLevel(EDashScalabilityLevel Level) const
+{
+	// Config may hold fewer levels; fall back to the closest lower one.
+	return SignificanceLevels.Num() > 0 ? &SignificanceLevels[FMath::Min((int32)Level, SignificanceLevels.Num() - 1)] : nullptr;
+}
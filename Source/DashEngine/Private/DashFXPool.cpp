@@ -0,0 +1,357 @@
+////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2019 GalaxySoftware Studio
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#include "DashFXPool.h"
+#include "DashEngine.h"
+
+#include "DashEngineSettings.h"
+#include "DashSignificanceManager.h"
+#include "Components/AudioComponent.h"
+#include "Engine/Engine.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Sound/SoundBase.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash FX Pool Hits"), STAT_DashFXPoolHits, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash FX Pool Misses"), STAT_DashFXPoolMisses, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash FX Pool Over Budget"), STAT_DashFXPoolOverBudget, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash FX Pool Insignificant"), STAT_DashFXPoolInsignificant, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dash FX Pool Active Components"), STAT_DashFXPoolActiveComponents, STATGROUP_Character);
+
+// CVars.
+namespace DashFXPoolCVars
+{
+	static int32 ParticleBudget = 16;
+	FAutoConsoleVariableRef CVarParticleBudget(
+		TEXT("p.DashFXParticleBudget"),
+		ParticleBudget,
+		TEXT("Maximum amount of pooled particle systems spawned per frame; more are dropped. 0 for no limit."),
+		ECVF_Default);
+
+	static int32 SoundBudget = 8;
+	FAutoConsoleVariableRef CVarSoundBudget(
+		TEXT("p.DashFXSoundBudget"),
+		SoundBudget,
+		TEXT("Maximum amount of pooled sounds played per frame; more are dropped. 0 for no limit."),
+		ECVF_Default);
+}
+
+
+void UDashFXPoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PoolActor = nullptr;
+	MaxFreeComponents = GetDefault<UDashEngineSettings>()->MaxPooledFXComponents;
+	BudgetFrame = 0;
+	NumParticlesSpawned = 0;
+	NumSoundsSpawned = 0;
+	ActorsInitializedHandle = FWorldDelegates::OnWorldInitializedActors.AddUObject(this, &UDashFXPoolSubsystem::OnActorsInitialized);
+}
+
+void UDashFXPoolSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldInitializedActors.Remove(ActorsInitializedHandle);
+	ParticlePools.Reset();
+	FreeAudioComponents.Reset();
+	PoolActor = nullptr;
+
+	Super::Deinitialize();
+}
+
+UParticleSystemComponent* UDashFXPoolSubsystem::SpawnEmitterAtLocation(UParticleSystem* Template, const FVector& Location, const FRotator& Rotation, const FVector& Scale)
+{
+	UWorld* World = GetWorld();
+	if (Template == nullptr || World == nullptr || World->GetNetMode() == NM_DedicatedServer)
+	{
+		return nullptr;
+	}
+
+	// Effects nobody would notice at this scalability level don't use the budget.
+	const UDashSignificanceManager* SignificanceManager = World->GetSubsystem<UDashSignificanceManager>();
+	if (SignificanceManager != nullptr && SignificanceManager->ShouldCullFX(Location))
+	{
+		INC_DWORD_STAT(STAT_DashFXPoolInsignificant);
+		return nullptr;
+	}
+
+	if (!ConsumeBudget(NumParticlesSpawned, DashFXPoolCVars::ParticleBudget))
+	{
+		INC_DWORD_STAT(STAT_DashFXPoolOverBudget);
+		return nullptr;
+	}
+
+	UParticleSystemComponent* Component = nullptr;
+
+	// Finished components may have been destroyed since, e.g. with their world.
+	TArray<UParticleSystemComponent*>& FreeComponents = ParticlePools.FindOrAdd(Template).FreeComponents;
+	while (Component == nullptr && FreeComponents.Num() > 0)
+	{
+		Component = FreeComponents.Pop(false);
+		Component = IsValid(Component) ? Component : nullptr;
+	}
+
+	if (Component != nullptr)
+	{
+		INC_DWORD_STAT(STAT_DashFXPoolHits);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_DashFXPoolMisses);
+		Component = CreateParticleComponent(Template);
+	}
+
+	INC_DWORD_STAT(STAT_DashFXPoolActiveComponents);
+
+	Component->SetWorldLocationAndRotation(Location, Rotation);
+	Component->SetWorldScale3D(Scale);
+	Component->ActivateSystem(true);
+
+	return Component;
+}
+
+UAudioComponent* UDashFXPoolSubsystem::PlaySoundAtLocation(USoundBase* Sound, const FVector& Location, const FRotator& Rotation, float VolumeMultiplier, float PitchMultiplier,
+	float StartTime, USoundAttenuation* AttenuationSettings, USoundConcurrency* ConcurrencySettings)
+{
+	UWorld* World = GetWorld();
+	if (Sound == nullptr || World == nullptr || !World->bAllowAudioPlayback || World->GetNetMode() == NM_DedicatedServer || GEngine == nullptr || !GEngine->UseSound())
+	{
+		return nullptr;
+	}
+
+	if (!ConsumeBudget(NumSoundsSpawned, DashFXPoolCVars::SoundBudget))
+	{
+		INC_DWORD_STAT(STAT_DashFXPoolOverBudget);
+		return nullptr;
+	}
+
+	UAudioComponent* Component = nullptr;
+
+	while (Component == nullptr && FreeAudioComponents.Num() > 0)
+	{
+		Component = FreeAudioComponents.Pop(false);
+		Component = IsValid(Component) ? Component : nullptr;
+	}
+
+	if (Component != nullptr)
+	{
+		INC_DWORD_STAT(STAT_DashFXPoolHits);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_DashFXPoolMisses);
+		Component = CreateAudioComponent();
+	}
+
+	INC_DWORD_STAT(STAT_DashFXPoolActiveComponents);
+
+	Component->SetSound(Sound);
+	Component->SetWorldLocationAndRotation(Location, Rotation);
+	Component->VolumeMultiplier = VolumeMultiplier;
+	Component->PitchMultiplier = PitchMultiplier;
+	Component->AttenuationSettings = AttenuationSettings;
+
+	Component->ConcurrencySet.Reset();
+	if (ConcurrencySettings != nullptr)
+	{
+		Component->ConcurrencySet.Add(ConcurrencySettings);
+	}
+
+	Component->Play(StartTime);
+
+	// Sounds that don't start (e.g. out of range or rejected by concurrency) never finish.
+	if (!Component->IsActive())
+	{
+		OnSoundFinished(Component);
+		return nullptr;
+	}
+
+	return Component;
+}
+
+void UDashFXPoolSubsystem::PrewarmParticles(UParticleSystem* Template, int32 Count)
+{
+	UWorld* World = GetWorld();
+	if (Template == nullptr || World == nullptr || World->GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+
+	TArray<UParticleSystemComponent*>& FreeComponents = ParticlePools.FindOrAdd(Template).FreeComponents;
+	Count = FMath::Min(Count, MaxFreeComponents);
+
+	while (FreeComponents.Num() < Count)
+	{
+		FreeComponents.Add(CreateParticleComponent(Template));
+	}
+}
+
+void UDashFXPoolSubsystem::PrewarmSounds(int32 Count)
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr || World->GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+
+	Count = FMath::Min(Count, MaxFreeComponents);
+
+	while (FreeAudioComponents.Num() < Count)
+	{
+		FreeAudioComponents.Add(CreateAudioComponent());
+	}
+}
+
+void UDashFXPoolSubsystem::OnActorsInitialized(const UWorld::FActorsInitializedParams& Params)
+{
+	if (Params.World != GetWorld() || !Params.World->IsGameWorld())
+	{
+		return;
+	}
+
+	const UDashEngineSettings* Settings = GetDefault<UDashEngineSettings>();
+
+	for (const FDashParticlePoolWarmUp& Entry : Settings->ParticlePoolWarmUp)
+	{
+		if (UParticleSystem* Template = Entry.Template.LoadSynchronous())
+		{
+			PrewarmParticles(Template, Entry.Count);
+		}
+	}
+
+	PrewarmSounds(Settings->SoundPoolWarmUp);
+}
+
+bool UDashFXPoolSubsystem::ConsumeBudget(int32& NumSpawned, int32 Budget)
+{
+	if (BudgetFrame != GFrameCounter)
+	{
+		BudgetFrame = GFrameCounter;
+		NumParticlesSpawned = 0;
+		NumSoundsSpawned = 0;
+	}
+
+	if (Budget > 0 && NumSpawned >= Budget)
+	{
+		return false;
+	}
+
+	NumSpawned++;
+	return true;
+}
+
+AActor* UDashFXPoolSubsystem::GetPoolActor()
+{
+	if (PoolActor == nullptr)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.Name = TEXT("DashFXPool");
+		SpawnParameters.ObjectFlags = RF_Transient;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		PoolActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+
+		USceneComponent* Root = NewObject<USceneComponent>(PoolActor, TEXT("Root"));
+		PoolActor->SetRootComponent(Root);
+		Root->RegisterComponent();
+	}
+
+	return PoolActor;
+}
+
+UParticleSystemComponent* UDashFXPoolSubsystem::CreateParticleComponent(UParticleSystem* Template)
+{
+	AActor* Actor = GetPoolActor();
+
+	// Components aren't attached, so their transform is in world space.
+	UParticleSystemComponent* Component = NewObject<UParticleSystemComponent>(Actor);
+	Component->bAutoActivate = false;
+	Component->bAutoDestroy = false;
+	Component->SetTemplate(Template);
+	Component->OnSystemFinished.AddDynamic(this, &UDashFXPoolSubsystem::OnParticleFinished);
+	Component->RegisterComponent();
+
+	return Component;
+}
+
+UAudioComponent* UDashFXPoolSubsystem::CreateAudioComponent()
+{
+	AActor* Actor = GetPoolActor();
+
+	UAudioComponent* Component = NewObject<UAudioComponent>(Actor);
+	Component->bAutoActivate = false;
+	Component->bAutoDestroy = false;
+	Component->bAllowSpatialization = true;
+	Component->OnAudioFinishedNative.AddUObject(this, &UDashFXPoolSubsystem::OnSoundFinished);
+	Component->RegisterComponent();
+
+	return Component;
+}
+
+void UDashFXPoolSubsystem::OnParticleFinished(UParticleSystemComponent* Component)
+{
+	DEC_DWORD_STAT(STAT_DashFXPoolActiveComponents);
+
+	TArray<UParticleSystemComponent*>& FreeComponents = ParticlePools.FindOrAdd(Component->Template).FreeComponents;
+	if (FreeComponents.Num() < MaxFreeComponents)
+	{
+		FreeComponents.Add(Component);
+	}
+	else
+	{
+		Component->DestroyComponent();
+	}
+}
+
+void UDashFXPoolSubsystem::OnSoundFinished(UAudioComponent* Component)
+{
+	DEC_DWORD_STAT(STAT_DashFXPoolActiveComponents);
+
+	if (FreeAudioComponents.Num() < MaxFreeComponents)
+	{
+		FreeAudioComponents.Add(Component);
+	}
+	else
+	{
+		Component->DestroyComponent();
+	}
+}
+
+
+UParticleSystemComponent* UDashFXPoolLibrary::SpawnPooledEmitterAtLocation(const UObject* WorldContextObject, UParticleSystem* EmitterTemplate, FVector Location,
+	FRotator Rotation, FVector Scale)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	UDashFXPoolSubsystem* FXPool = World != nullptr ? World->GetSubsystem<UDashFXPoolSubsystem>() : nullptr;
+
+	return FXPool != nullptr ? FXPool->SpawnEmitterAtLocation(EmitterTemplate, Location, Rotation, Scale) : nullptr;
+}
+
+UAudioComponent* UDashFXPoolLibrary::PlayPooledSoundAtLocation(const UObject* WorldContextObject, USoundBase* Sound, FVector Location, FRotator Rotation,
+	float VolumeMultiplier, float PitchMultiplier, float StartTime, USoundAttenuation* AttenuationSettings, USoundConcurrency* ConcurrencySettings)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	UDashFXPoolSubsystem* FXPool = World != nullptr ? World->GetSubsystem<UDashFXPoolSubsystem>() : nullptr;
+
+	return FXPool != nullptr ? FXPool->PlaySoundAtLocation(Sound, Location, Rotation, VolumeMultiplier, PitchMultiplier, StartTime, AttenuationSettings, ConcurrencySettings) : nullptr;
+}
@@ -0,0 +1,404 @@
+////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2019 GalaxySoftware Studio
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#include "DashGravityField.h"
+#include "DashEngine.h"
+
+#include "Components/SceneComponent.h"
+#include "Components/SplineComponent.h"
+#include "Engine/World.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDashGravityField, Log, All);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash Gravity Field Cells"), STAT_DashGravityFieldCells, STATGROUP_Character);
+
+// CVars.
+namespace DashGravityFieldCVars
+{
+	static float CellSize = 2000.0f;
+	FAutoConsoleVariableRef CVarCellSize(
+		TEXT("p.DashGravityFieldCellSize"),
+		CellSize,
+		TEXT("Size of the cells of the gravity field grid; read when a world starts."),
+		ECVF_Default);
+}
+
+// Statics.
+namespace DashGravityFieldStatics
+{
+	// Samples per spline segment used to bound it.
+	static const int32 SegmentBoundsSamples = 8;
+
+	// Volumes covering more cells than this are tested against their bounds instead; they should be split or the cells made larger.
+	static const int32 MaxCellsPerVolume = 1 << 18;
+}
+
+
+ADashGravityVolume::ADashGravityVolume()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent->SetMobility(EComponentMobility::Static);
+
+	Spline = CreateDefaultSubobject<USplineComponent>(TEXT("Spline"));
+	Spline->SetupAttachment(RootComponent);
+
+	Shape = EDashGravityShape::Sphere;
+	Radius = 2000.0f;
+	Height = 2000.0f;
+	Extent = FVector(2000.0f, 2000.0f, 1000.0f);
+	BlendDistance = 200.0f;
+	GravityScale = 1.0f;
+	bInvertDirection = false;
+	Priority = 0;
+}
+
+void ADashGravityVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UDashGravityFieldSubsystem* GravityField = GetWorld()->GetSubsystem<UDashGravityFieldSubsystem>())
+	{
+		GravityField->RegisterVolume(this);
+	}
+}
+
+void ADashGravityVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UDashGravityFieldSubsystem* GravityField = GetWorld()->GetSubsystem<UDashGravityFieldSubsystem>())
+	{
+		GravityField->UnregisterVolume(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+float ADashGravityVolume::GetGravityAt(const FVector& Location, int32 FirstSegment, int32 NumSegments, FVector& OutDirection) const
+{
+	// Direction toward the center, axis or spline, and depth inside the boundary.
+	FVector Direction = FVector::ZeroVector;
+	float Depth = -1.0f;
+
+	const FVector LocalLocation = GetActorQuat().UnrotateVector(Location - GetActorLocation());
+
+	switch (Shape)
+	{
+	case EDashGravityShape::Sphere:
+	{
+		Direction = -LocalLocation;
+		Depth = Radius - LocalLocation.Size();
+		break;
+	}
+
+	case EDashGravityShape::Cylinder:
+	{
+		Direction = FVector(-LocalLocation.X, -LocalLocation.Y, 0.0f);
+		Depth = FMath::Min(Radius - Direction.Size(), Height * 0.5f - FMath::Abs(LocalLocation.Z));
+		break;
+	}
+
+	case EDashGravityShape::Plane:
+	{
+		Direction = FVector(0.0f, 0.0f, -1.0f);
+		Depth = (Extent - LocalLocation.GetAbs()).GetMin();
+		break;
+	}
+
+	case EDashGravityShape::SplineTube:
+	{
+		const FTransform& SplineTransform = Spline->GetComponentTransform();
+		const FVector SplineLocation = SplineTransform.InverseTransformPosition(Location);
+		const FInterpCurveVector& Positions = Spline->SplineCurves.Position;
+
+		float ClosestKey = 0.0f;
+		float ClosestDistanceSquared = BIG_NUMBER;
+		for (int32 SegmentIndex = FirstSegment; SegmentIndex < FirstSegment + NumSegments; ++SegmentIndex)
+		{
+			float DistanceSquared;
+			const float Key = Positions.InaccurateFindNearestOnSegment(SplineLocation, SegmentIndex, DistanceSquared);
+			if (DistanceSquared < ClosestDistanceSquared)
+			{
+				ClosestKey = Key;
+				ClosestDistanceSquared = DistanceSquared;
+			}
+		}
+
+		if (ClosestDistanceSquared < BIG_NUMBER)
+		{
+			Direction = SplineTransform.TransformPosition(Positions.Eval(ClosestKey, FVector::ZeroVector)) - Location;
+			Depth = Radius - Direction.Size();
+
+			// Direction is computed in world space.
+			OutDirection = Direction.GetSafeNormal() * (bInvertDirection ? -GravityScale : GravityScale);
+			return BlendDistance > 0.0f ? FMath::Clamp(Depth / BlendDistance, 0.0f, 1.0f) : (Depth >= 0.0f ? 1.0f : 0.0f);
+		}
+
+		break;
+	}
+	}
+
+	OutDirection = GetActorQuat().RotateVector(Direction.GetSafeNormal()) * (bInvertDirection ? -GravityScale : GravityScale);
+	return BlendDistance > 0.0f ? FMath::Clamp(Depth / BlendDistance, 0.0f, 1.0f) : (Depth >= 0.0f ? 1.0f : 0.0f);
+}
+
+FBox ADashGravityVolume::GetGravityBounds() const
+{
+	FVector LocalExtent;
+
+	switch (Shape)
+	{
+	case EDashGravityShape::Sphere:
+		return FBox::BuildAABB(GetActorLocation(), FVector(Radius));
+
+	case EDashGravityShape::Cylinder:
+		LocalExtent = FVector(Radius, Radius, Height * 0.5f);
+		break;
+
+	case EDashGravityShape::Plane:
+		LocalExtent = Extent;
+		break;
+
+	default:
+	{
+		FBox Bounds(ForceInit);
+		for (int32 SegmentIndex = 0; SegmentIndex < GetNumSegments(); ++SegmentIndex)
+		{
+			Bounds += GetSegmentBounds(SegmentIndex);
+		}
+
+		return Bounds;
+	}
+	}
+
+	return FBox(-LocalExtent, LocalExtent).TransformBy(FTransform(GetActorQuat(), GetActorLocation()));
+}
+
+FBox ADashGravityVolume::GetSegmentBounds(int32 SegmentIndex) const
+{
+	const float StartDistance = Spline->GetDistanceAlongSplineAtSplinePoint(SegmentIndex);
+	const float EndDistance = SegmentIndex + 1 < Spline->GetNumberOfSplinePoints() ?
+		Spline->GetDistanceAlongSplineAtSplinePoint(SegmentIndex + 1) : Spline->GetSplineLength();
+
+	FBox Bounds(ForceInit);
+	for (int32 SampleIndex = 0; SampleIndex <= DashGravityFieldStatics::SegmentBoundsSamples; ++SampleIndex)
+	{
+		const float Alpha = (float)SampleIndex / DashGravityFieldStatics::SegmentBoundsSamples;
+		Bounds += Spline->GetLocationAtDistanceAlongSpline(FMath::Lerp(StartDistance, EndDistance, Alpha), ESplineCoordinateSpace::World);
+	}
+
+	// Samples can miss the bulge of a segment between them; pad by a sample interval.
+	const float Padding = (EndDistance - StartDistance) / DashGravityFieldStatics::SegmentBoundsSamples;
+
+	return Bounds.ExpandBy(Radius + BlendDistance + Padding);
+}
+
+int32 ADashGravityVolume::GetNumSegments() const
+{
+	return Shape == EDashGravityShape::SplineTube ? Spline->GetNumberOfSplineSegments() : 0;
+}
+
+
+void UDashGravityFieldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	CellSize = FMath::Max(DashGravityFieldCVars::CellSize, 100.0f);
+}
+
+void UDashGravityFieldSubsystem::Deinitialize()
+{
+	Volumes.Reset();
+	Cells.Reset();
+	LargeEntries.Reset();
+
+	Super::Deinitialize();
+}
+
+void UDashGravityFieldSubsystem::RegisterVolume(ADashGravityVolume* Volume)
+{
+	if (Volume == nullptr || Volumes.Contains(Volume))
+	{
+		return;
+	}
+
+	Volumes.Add(Volume);
+
+	const int32 NumSegments = Volume->GetNumSegments();
+	if (NumSegments == 0)
+	{
+		AddEntry(Volume->GetGravityBounds(), { Volume, 0, 0 });
+	}
+	else
+	{
+		// Cells only search the segments of the tube that cross them.
+		for (int32 SegmentIndex = 0; SegmentIndex < NumSegments; ++SegmentIndex)
+		{
+			AddEntry(Volume->GetSegmentBounds(SegmentIndex), { Volume, SegmentIndex, 1 });
+		}
+	}
+
+	SET_DWORD_STAT(STAT_DashGravityFieldCells, Cells.Num());
+}
+
+void UDashGravityFieldSubsystem::UnregisterVolume(ADashGravityVolume* Volume)
+{
+	if (Volumes.Remove(Volume) == 0)
+	{
+		return;
+	}
+
+	for (auto It = Cells.CreateIterator(); It; ++It)
+	{
+		It.Value().RemoveAll([Volume](const FDashGravityFieldEntry& Entry) { return Entry.Volume == Volume; });
+		if (It.Value().Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	LargeEntries.RemoveAll([Volume](const FDashGravityFieldLargeEntry& Large) { return Large.Entry.Volume == Volume; });
+
+	SET_DWORD_STAT(STAT_DashGravityFieldCells, Cells.Num());
+}
+
+void UDashGravityFieldSubsystem::UpdateVolume(ADashGravityVolume* Volume)
+{
+	UnregisterVolume(Volume);
+	RegisterVolume(Volume);
+}
+
+float UDashGravityFieldSubsystem::GetGravityAt(const FVector& Location, FVector& OutGravity) const
+{
+	OutGravity = FVector::ZeroVector;
+
+	const auto* Entries = Cells.Find(GetCell(Location));
+	const int32 NumCellEntries = Entries != nullptr ? Entries->Num() : 0;
+	if (NumCellEntries == 0 && LargeEntries.Num() == 0)
+	{
+		return 0.0f;
+	}
+
+	// Each volume takes its share of what higher priority volumes left; cell and large entries are merged by priority.
+	float Remaining = 1.0f;
+	int32 CellIndex = 0;
+	int32 LargeIndex = 0;
+	while (CellIndex < NumCellEntries || LargeIndex < LargeEntries.Num())
+	{
+		const FDashGravityFieldEntry* Entry;
+		if (LargeIndex == LargeEntries.Num() ||
+			(CellIndex < NumCellEntries && (*Entries)[CellIndex].Volume->Priority >= LargeEntries[LargeIndex].Entry.Volume->Priority))
+		{
+			Entry = &(*Entries)[CellIndex++];
+		}
+		else
+		{
+			const FDashGravityFieldLargeEntry& Large = LargeEntries[LargeIndex++];
+			if (!Large.Bounds.IsInsideOrOn(Location))
+			{
+				continue;
+			}
+
+			Entry = &Large.Entry;
+		}
+
+		FVector Direction;
+		const float Weight = Entry->Volume->GetGravityAt(Location, Entry->FirstSegment, Entry->NumSegments, Direction) * Remaining;
+		if (Weight > 0.0f)
+		{
+			OutGravity += Direction * Weight;
+			Remaining -= Weight;
+
+			if (Remaining <= KINDA_SMALL_NUMBER)
+			{
+				return 1.0f;
+			}
+		}
+	}
+
+	return 1.0f - Remaining;
+}
+
+FIntVector UDashGravityFieldSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void UDashGravityFieldSubsystem::AddEntry(const FBox& Bounds, const FDashGravityFieldEntry& Entry)
+{
+	if (!Bounds.IsValid)
+	{
+		return;
+	}
+
+	const FIntVector MinCell = GetCell(Bounds.Min);
+	const FIntVector MaxCell = GetCell(Bounds.Max);
+	const FIntVector NumCells = MaxCell - MinCell + FIntVector(1);
+
+	if ((int64)NumCells.X * NumCells.Y * NumCells.Z > DashGravityFieldStatics::MaxCellsPerVolume)
+	{
+		UE_LOG(LogDashGravityField, Warning, TEXT("%s covers %d x %d x %d gravity field cells and is tested against its bounds instead; raise p.DashGravityFieldCellSize."),
+			*Entry.Volume->GetName(), NumCells.X, NumCells.Y, NumCells.Z);
+
+		int32 Index = 0;
+		while (Index < LargeEntries.Num() && LargeEntries[Index].Entry.Volume->Priority >= Entry.Volume->Priority)
+		{
+			Index++;
+		}
+
+		LargeEntries.Insert({ Entry, Bounds }, Index);
+		return;
+	}
+
+	for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+			{
+				auto& Entries = Cells.FindOrAdd(FIntVector(X, Y, Z));
+
+				// Extend the entry of the previous segment of the same tube.
+				FDashGravityFieldEntry* PreviousEntry = Entries.FindByPredicate([&Entry](const FDashGravityFieldEntry& Other)
+				{
+					return Other.Volume == Entry.Volume && Other.FirstSegment + Other.NumSegments == Entry.FirstSegment;
+				});
+
+				if (PreviousEntry != nullptr)
+				{
+					PreviousEntry->NumSegments += Entry.NumSegments;
+					continue;
+				}
+
+				// Keep entries sorted by decreasing priority.
+				int32 Index = 0;
+				while (Index < Entries.Num() && Entries[Index].Volume->Priority >= Entry.Volume->Priority)
+				{
+					Index++;
+				}
+
+				Entries.Insert(Entry, Index);
+			}
+		}
+	}
+}
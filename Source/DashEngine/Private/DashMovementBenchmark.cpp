@@ -0,0 +1,432 @@
+////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2019 GalaxySoftware Studio
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#include "DashMovementBenchmark.h"
+#include "DashEngine.h"
+
+#include "EngineUtils.h"
+#include "Kismet/GameplayStatics.h"
+#include "GameFramework/PlayerStart.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SplineComponent.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "DashCharacter.h"
+#include "DashCharacterMovementComponent.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDashBenchmark, Log, All);
+
+// Benchmark settings.
+namespace DashMovementBenchmarkStatics
+{
+	static const float LoadTimeout = 120.0f;
+	static const float CharacterSpacing = 200.0f;
+	static const float CircleRate = 1.5f;
+	static const float JumpInterval = 1.5f;
+	static const float JumpHoldTime = 0.2f;
+	static const FName RailTag = FName(TEXT("Rail"));
+}
+
+
+bool UDashMovementBenchmark::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("DashBenchmark"));
+}
+
+void UDashMovementBenchmark::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+
+	FString MapList;
+	if (FParse::Value(CommandLine, TEXT("BenchmarkMaps="), MapList, false))
+	{
+		MapList.ParseIntoArray(Maps, TEXT("+"));
+	}
+	else
+	{
+		Maps = { TEXT("TestMap"), TEXT("2DTestMap"), TEXT("TrickAndRailTest") };
+	}
+
+	NumCharacters = 16;
+	WarmupDuration = 3.0f;
+	Duration = 20.0f;
+	ResetInterval = 10.0f;
+	FParse::Value(CommandLine, TEXT("BenchmarkCharacters="), NumCharacters);
+	FParse::Value(CommandLine, TEXT("BenchmarkWarmup="), WarmupDuration);
+	FParse::Value(CommandLine, TEXT("BenchmarkDuration="), Duration);
+	FParse::Value(CommandLine, TEXT("BenchmarkResetInterval="), ResetInterval);
+	NumCharacters = FMath::Max(NumCharacters, 1);
+
+	// A Blueprint character can be given to benchmark its mesh and animation too.
+	CharacterClass = ADashCharacter::StaticClass();
+	FString CharacterClassPath;
+	if (FParse::Value(CommandLine, TEXT("BenchmarkCharacterClass="), CharacterClassPath))
+	{
+		UClass* LoadedClass = LoadClass<ADashCharacter>(nullptr, *CharacterClassPath);
+		if (LoadedClass != nullptr)
+		{
+			CharacterClass = LoadedClass;
+		}
+		else
+		{
+			UE_LOG(LogDashBenchmark, Warning, TEXT("Couldn't load character class %s, using ADashCharacter."), *CharacterClassPath);
+		}
+	}
+
+#if !CSV_PROFILER
+	UE_LOG(LogDashBenchmark, Warning, TEXT("CSV profiler is compiled out, only the summary will be written."));
+#endif
+
+	State = EState::Idle;
+	MapIndex = INDEX_NONE;
+	StateTime = 0.0f;
+	ResetTime = 0.0f;
+	NumFrames = 0;
+	GameThreadTimeSum = 0.0;
+	GameThreadTimeMax = 0.0;
+	Timestamp = FDateTime::Now().ToString();
+
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UDashMovementBenchmark::OnPostLoadMap);
+
+	UE_LOG(LogDashBenchmark, Log, TEXT("Benchmarking %d maps with %d characters, %.1f seconds each."), Maps.Num(), NumCharacters, Duration);
+}
+
+void UDashMovementBenchmark::Deinitialize()
+{
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+
+	Super::Deinitialize();
+}
+
+void UDashMovementBenchmark::Tick(float DeltaTime)
+{
+	StateTime += DeltaTime;
+
+	switch (State)
+	{
+	case EState::Idle:
+		LoadNextMap();
+		break;
+
+	case EState::Loading:
+		if (StateTime > DashMovementBenchmarkStatics::LoadTimeout)
+		{
+			UE_LOG(LogDashBenchmark, Error, TEXT("Timed out while loading %s."), *Maps[MapIndex]);
+			Results.Add(FString::Printf(TEXT("%s,%d,0,0,0,LoadFailed"), *Maps[MapIndex], NumCharacters));
+			LoadNextMap();
+		}
+		break;
+
+	case EState::WarmingUp:
+		DriveCharacters(DeltaTime);
+
+		if (StateTime >= WarmupDuration)
+		{
+#if CSV_PROFILER
+			FCsvProfiler::Get()->BeginCapture(-1, FPaths::ProfilingDir() / TEXT("DashBenchmark"),
+				FString::Printf(TEXT("DashMovement-%s-%s.csv"), *FPackageName::GetShortName(Maps[MapIndex]), *Timestamp));
+#endif
+
+			NumFrames = 0;
+			GameThreadTimeSum = 0.0;
+			GameThreadTimeMax = 0.0;
+			State = EState::Running;
+			StateTime = 0.0f;
+		}
+		break;
+
+	case EState::Running:
+	{
+		DriveCharacters(DeltaTime);
+
+		// Game thread time of the previous frame; the first one is still part of the warm up.
+		if (NumFrames > 0)
+		{
+			const double GameThreadTime = FPlatformTime::ToMilliseconds(GGameThreadTime);
+			GameThreadTimeSum += GameThreadTime;
+			GameThreadTimeMax = FMath::Max(GameThreadTimeMax, GameThreadTime);
+		}
+
+		NumFrames++;
+
+		if (StateTime >= Duration)
+		{
+			FinishMap();
+			LoadNextMap();
+		}
+		break;
+	}
+
+	default:
+		break;
+	}
+}
+
+bool UDashMovementBenchmark::IsTickable() const
+{
+	return State != EState::Finished && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UDashMovementBenchmark::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDashMovementBenchmark, STATGROUP_Tickables);
+}
+
+void UDashMovementBenchmark::LoadNextMap()
+{
+	Characters.Reset();
+	Rails.Reset();
+
+	MapIndex++;
+	if (!Maps.IsValidIndex(MapIndex))
+	{
+		WriteSummary();
+		return;
+	}
+
+	UE_LOG(LogDashBenchmark, Log, TEXT("Loading %s."), *Maps[MapIndex]);
+
+	State = EState::Loading;
+	StateTime = 0.0f;
+	UGameplayStatics::OpenLevel(GetGameInstance(), FName(*Maps[MapIndex]));
+}
+
+void UDashMovementBenchmark::OnPostLoadMap(UWorld* World)
+{
+	if (State != EState::Loading || World == nullptr)
+	{
+		return;
+	}
+
+	// A failed travel falls back to the default map.
+	if (!World->GetMapName().Equals(FPackageName::GetShortName(Maps[MapIndex]), ESearchCase::IgnoreCase))
+	{
+		UE_LOG(LogDashBenchmark, Error, TEXT("Couldn't load %s, got %s instead."), *Maps[MapIndex], *World->GetMapName());
+		Results.Add(FString::Printf(TEXT("%s,%d,0,0,0,LoadFailed"), *Maps[MapIndex], NumCharacters));
+		State = EState::Idle;
+		return;
+	}
+
+	SpawnCharacters(World);
+
+	State = EState::WarmingUp;
+	StateTime = 0.0f;
+	ResetTime = 0.0f;
+}
+
+void UDashMovementBenchmark::SpawnCharacters(UWorld* World)
+{
+	// Rails are the splines of actors tagged as such.
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		if (It->ActorHasTag(DashMovementBenchmarkStatics::RailTag))
+		{
+			TArray<USplineComponent*> Splines;
+			It->GetComponents<USplineComponent>(Splines);
+			Rails.Append(Splines);
+		}
+	}
+
+	FTransform StartTransform = FTransform::Identity;
+	TActorIterator<APlayerStart> PlayerStart(World);
+	if (PlayerStart)
+	{
+		StartTransform = PlayerStart->GetActorTransform();
+	}
+
+	// Characters are laid out on a grid behind the player start.
+	const int32 NumColumns = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumCharacters)));
+	const FRotator StartRotation = StartTransform.Rotator();
+
+	Characters.SetNum(NumCharacters);
+	for (int32 Index = 0; Index < NumCharacters; Index++)
+	{
+		const FVector Offset((Index / NumColumns) * -DashMovementBenchmarkStatics::CharacterSpacing,
+			((Index % NumColumns) - (NumColumns - 1) * 0.5f) * DashMovementBenchmarkStatics::CharacterSpacing, 0.0f);
+
+		FDashBenchmarkCharacter& BenchmarkCharacter = Characters[Index];
+		BenchmarkCharacter.Script = static_cast<EDashBenchmarkScript>(Index % static_cast<int32>(EDashBenchmarkScript::MAX));
+		BenchmarkCharacter.SpawnTransform = FTransform(StartRotation, StartTransform.TransformPosition(Offset));
+		BenchmarkCharacter.JumpTime = DashMovementBenchmarkStatics::JumpInterval * Index / NumCharacters;
+
+		ResetCharacter(BenchmarkCharacter, Index);
+	}
+
+	UE_LOG(LogDashBenchmark, Log, TEXT("Spawned %d characters in %s (%d rails)."), NumCharacters, *World->GetMapName(), Rails.Num());
+}
+
+void UDashMovementBenchmark::ResetCharacter(FDashBenchmarkCharacter& BenchmarkCharacter, int32 Index)
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	if (!IsValid(BenchmarkCharacter.Character))
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+		BenchmarkCharacter.Character = World->SpawnActor<ADashCharacter>(CharacterClass, BenchmarkCharacter.SpawnTransform, SpawnParams);
+		if (BenchmarkCharacter.Character == nullptr)
+		{
+			return;
+		}
+
+		// Characters aren't possessed, the benchmark feeds their input.
+		BenchmarkCharacter.Character->GetCharacterMovement()->bRunPhysicsWithNoController = true;
+	}
+
+	ADashCharacter* Character = BenchmarkCharacter.Character;
+	UDashCharacterMovementComponent* MovementComponent = Cast<UDashCharacterMovementComponent>(Character->GetCharacterMovement());
+
+	if (BenchmarkCharacter.Script == EDashBenchmarkScript::Rail && Rails.Num() > 0 && MovementComponent != nullptr)
+	{
+		USplineComponent* Rail = Rails[Index % Rails.Num()];
+		const FVector RailStart = Rail->GetLocationAtSplinePoint(0, ESplineCoordinateSpace::World) +
+			Rail->GetUpVectorAtSplinePoint(0, ESplineCoordinateSpace::World) * Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+		Character->TeleportTo(RailStart, Rail->GetRotationAtSplinePoint(0, ESplineCoordinateSpace::World), false, true);
+		MovementComponent->Velocity = Rail->GetDirectionAtSplinePoint(0, ESplineCoordinateSpace::World) * MovementComponent->GrindMinSpeed;
+		MovementComponent->StartGrinding(Rail);
+	}
+	else
+	{
+		Character->TeleportTo(BenchmarkCharacter.SpawnTransform.GetLocation(), BenchmarkCharacter.SpawnTransform.Rotator(), false, true);
+		Character->GetCharacterMovement()->Velocity = FVector::ZeroVector;
+	}
+}
+
+void UDashMovementBenchmark::DriveCharacters(float DeltaTime)
+{
+	ResetTime += DeltaTime;
+	const bool bResetAll = ResetTime >= ResetInterval;
+	if (bResetAll)
+	{
+		ResetTime = 0.0f;
+	}
+
+	for (int32 Index = 0; Index < Characters.Num(); Index++)
+	{
+		FDashBenchmarkCharacter& BenchmarkCharacter = Characters[Index];
+		if (bResetAll || !IsValid(BenchmarkCharacter.Character))
+		{
+			ResetCharacter(BenchmarkCharacter, Index);
+		}
+
+		ADashCharacter* Character = BenchmarkCharacter.Character;
+		if (Character == nullptr)
+		{
+			continue;
+		}
+
+		EDashBenchmarkScript Script = BenchmarkCharacter.Script;
+		if (Script == EDashBenchmarkScript::Rail && Rails.Num() == 0)
+		{
+			Script = EDashBenchmarkScript::Circle;
+		}
+
+		switch (Script)
+		{
+		case EDashBenchmarkScript::Circle:
+		{
+			const float Angle = StateTime * DashMovementBenchmarkStatics::CircleRate + Index;
+			const FVector Direction = BenchmarkCharacter.SpawnTransform.TransformVectorNoScale(FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f));
+			Character->AddMovementInput(Direction);
+			break;
+		}
+
+		case EDashBenchmarkScript::Jump:
+			BenchmarkCharacter.JumpTime -= DeltaTime;
+			if (BenchmarkCharacter.JumpTime <= 0.0f)
+			{
+				Character->Jump();
+				BenchmarkCharacter.JumpTime = DashMovementBenchmarkStatics::JumpInterval;
+			}
+			else if (BenchmarkCharacter.JumpTime < DashMovementBenchmarkStatics::JumpInterval - DashMovementBenchmarkStatics::JumpHoldTime)
+			{
+				Character->StopJumping();
+			}
+
+			Character->AddMovementInput(Character->GetActorForwardVector());
+			break;
+
+		default:
+			// Forward follows the floor, which takes the runners through loops.
+			Character->AddMovementInput(Character->GetActorForwardVector());
+			break;
+		}
+	}
+}
+
+void UDashMovementBenchmark::FinishMap()
+{
+#if CSV_PROFILER
+	FCsvProfiler::Get()->EndCapture();
+#endif
+
+	const int32 NumSamples = FMath::Max(NumFrames - 1, 1);
+	Results.Add(FString::Printf(TEXT("%s,%d,%d,%.3f,%.3f,DashMovement-%s-%s.csv"), *Maps[MapIndex], NumCharacters, NumFrames,
+		GameThreadTimeSum / NumSamples, GameThreadTimeMax, *FPackageName::GetShortName(Maps[MapIndex]), *Timestamp));
+
+	for (const FDashBenchmarkCharacter& BenchmarkCharacter : Characters)
+	{
+		if (IsValid(BenchmarkCharacter.Character))
+		{
+			BenchmarkCharacter.Character->Destroy();
+		}
+	}
+
+	UE_LOG(LogDashBenchmark, Log, TEXT("%s: %d frames, %.3f ms average game thread time."), *Maps[MapIndex], NumFrames, GameThreadTimeSum / NumSamples);
+}
+
+void UDashMovementBenchmark::WriteSummary()
+{
+	// Phase timings and sweep counts of each frame are in the capture files.
+	FString Summary = TEXT("Map,Characters,Frames,AvgGameThreadMs,MaxGameThreadMs,Capture") LINE_TERMINATOR;
+	for (const FString& Result : Results)
+	{
+		Summary += Result + LINE_TERMINATOR;
+	}
+
+	const FString SummaryPath = FPaths::ProfilingDir() / TEXT("DashBenchmark") / FString::Printf(TEXT("DashMovementBenchmark-%s.csv"), *Timestamp);
+	if (FFileHelper::SaveStringToFile(Summary, *SummaryPath))
+	{
+		UE_LOG(LogDashBenchmark, Log, TEXT("Benchmark summary written to %s."), *SummaryPath);
+	}
+	else
+	{
+		UE_LOG(LogDashBenchmark, Error, TEXT("Couldn't write benchmark summary to %s."), *SummaryPath);
+	}
+
+	State = EState::Finished;
+
+	// A graceful exit lets the CSV profiler flush the last capture.
+	FPlatformMisc::RequestExit(false);
+}
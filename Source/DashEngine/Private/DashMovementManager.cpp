@@ -0,0 +1,161 @@
+////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2019 GalaxySoftware Studio
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#include "DashMovementManager.h"
+#include "DashEngine.h"
+
+#include "Async/ParallelFor.h"
+#include "DashCharacterMovementComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Dash Movement Prepass"), STAT_DashMovementPrepass, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash Movement Prepass Components"), STAT_DashMovementPrepassComponents, STATGROUP_Character);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Dash Movement Prepass Speedup"), STAT_DashMovementPrepassSpeedup, STATGROUP_Character);
+
+// CVars.
+namespace DashMovementManagerCVars
+{
+	static int32 ParallelMovement = 1;
+	FAutoConsoleVariableRef CVarParallelMovement(
+		TEXT("p.DashParallelMovement"),
+		ParallelMovement,
+		TEXT("Whether the prepass of Dash character movement components runs in parallel.\n")
+		TEXT("0: Serial, 1: Parallel"),
+		ECVF_Default);
+}
+
+
+void FDashMovementManagerTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Manager != nullptr && TickType != LEVELTICK_ViewportsOnly && TickType != LEVELTICK_PauseTick)
+	{
+		Manager->Tick(DeltaTime);
+	}
+}
+
+FString FDashMovementManagerTickFunction::DiagnosticMessage()
+{
+	return TEXT("FDashMovementManagerTickFunction");
+}
+
+void UDashMovementManager::Deinitialize()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		TickFunction.UnRegisterTickFunction();
+	}
+
+	Components.Reset();
+
+	Super::Deinitialize();
+}
+
+void UDashMovementManager::RegisterComponent(UDashCharacterMovementComponent* Component)
+{
+	if (Component == nullptr || Components.Contains(Component))
+	{
+		return;
+	}
+
+	// Register the tick function with the first component.
+	if (!TickFunction.IsTickFunctionRegistered())
+	{
+		UWorld* World = GetWorld();
+		if (World == nullptr || World->PersistentLevel == nullptr)
+		{
+			return;
+		}
+
+		TickFunction.Manager = this;
+		TickFunction.TickGroup = TG_PrePhysics;
+		TickFunction.bCanEverTick = true;
+		TickFunction.bStartWithTickEnabled = true;
+		TickFunction.bTickEvenWhenPaused = false;
+		TickFunction.RegisterTickFunction(World->PersistentLevel);
+	}
+
+	Components.Add(Component);
+	Component->PrimaryComponentTick.AddPrerequisite(this, TickFunction);
+}
+
+void UDashMovementManager::UnregisterComponent(UDashCharacterMovementComponent* Component)
+{
+	if (Component != nullptr && Components.Remove(Component) > 0)
+	{
+		Component->PrimaryComponentTick.RemovePrerequisite(this, TickFunction);
+	}
+}
+
+void UDashMovementManager::GetCharacterLocations(TArray<FVector>& OutLocations) const
+{
+	OutLocations.Reset();
+	for (const UDashCharacterMovementComponent* Component : Components)
+	{
+		if (Component != nullptr && Component->UpdatedComponent != nullptr)
+		{
+			OutLocations.Add(Component->UpdatedComponent->GetComponentLocation());
+		}
+	}
+}
+
+void UDashMovementManager::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DashMovementPrepass);
+
+	PrepassComponents.Reset();
+	for (UDashCharacterMovementComponent* Component : Components)
+	{
+		if (Component != nullptr && !Component->IsPendingKill() && Component->ShouldPrepareMovement())
+		{
+			PrepassComponents.Add(Component);
+		}
+	}
+
+	PrepassCycles.SetNumZeroed(PrepassComponents.Num());
+	INC_DWORD_STAT_BY(STAT_DashMovementPrepassComponents, PrepassComponents.Num());
+
+	if (PrepassComponents.Num() == 0)
+	{
+		return;
+	}
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	// Each component only reads the world and writes its own prepass data.
+	ParallelFor(PrepassComponents.Num(), [this, DeltaTime](int32 Index)
+	{
+		const uint64 ComponentStartCycles = FPlatformTime::Cycles64();
+		PrepassComponents[Index]->PrepareMovement(DeltaTime);
+		PrepassCycles[Index] = FPlatformTime::Cycles64() - ComponentStartCycles;
+	}, DashMovementManagerCVars::ParallelMovement == 0);
+
+	const uint64 WallCycles = FPlatformTime::Cycles64() - StartCycles;
+
+	// Ratio of serial cost to elapsed time.
+	uint64 TotalCycles = 0;
+	for (const uint64 Cycles : PrepassCycles)
+	{
+		TotalCycles += Cycles;
+	}
+
+	SET_FLOAT_STAT(STAT_DashMovementPrepassSpeedup, WallCycles > 0 ? float(double(TotalCycles) / double(WallCycles)) : 1.0f);
+}
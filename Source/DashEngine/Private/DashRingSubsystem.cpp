@@ -0,0 +1,810 @@
+////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2019 GalaxySoftware Studio
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#include "DashRingSubsystem.h"
+#include "DashEngine.h"
+
+#include "DashCharacterMovementComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/SplineComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "TimerManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Dash Ring Collection"), STAT_DashRingCollection, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Dash Scattered Rings Tick"), STAT_DashScatteredRingsTick, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash Rings Active"), STAT_DashRingsActive, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash Rings Scattered"), STAT_DashRingsScattered, STATGROUP_Character);
+
+// CVars.
+namespace DashRingSubsystemCVars
+{
+	static float CellSize = 500.0f;
+	FAutoConsoleVariableRef CVarCellSize(
+		TEXT("p.DashRingCellSize"),
+		CellSize,
+		TEXT("Size of the cells of the ring spatial hash; read when a world starts."),
+		ECVF_Default);
+
+	static int32 ScatteredRingPoolSize = 128;
+	FAutoConsoleVariableRef CVarScatteredRingPoolSize(
+		TEXT("p.DashScatteredRingPoolSize"),
+		ScatteredRingPoolSize,
+		TEXT("Maximum amount of scattered rings alive at once; read when a world starts."),
+		ECVF_Default);
+
+	static int32 ScatteredRingTracesPerTick = 4;
+	FAutoConsoleVariableRef CVarScatteredRingTracesPerTick(
+		TEXT("p.DashScatteredRingTracesPerTick"),
+		ScatteredRingTracesPerTick,
+		TEXT("Amount of async line traces scattered rings refresh their bounce plane with each tick, round-robin."),
+		ECVF_Default);
+
+	static float ScatteredRingTraceLookahead = 0.25f;
+	FAutoConsoleVariableRef CVarScatteredRingTraceLookahead(
+		TEXT("p.DashScatteredRingTraceLookahead"),
+		ScatteredRingTraceLookahead,
+		TEXT("Time ahead along its trajectory a scattered ring traces for its bounce plane."),
+		ECVF_Default);
+}
+
+// Statics.
+namespace DashRingSubsystemStatics
+{
+	/** Amount of buckets of the scattered ring grid; a power of two. */
+	static const int32 NumScatterBuckets = 64;
+
+	/**
+	* Return whether a capsule swept along a move touches a ring.
+	*
+	* @param RingLocation - Location of the ring.
+	* @param RingRadius - Radius of the ring.
+	* @param Start - Start location of the capsule.
+	* @param Move - Move of the capsule.
+	* @param FlatMove - Move of the capsule, projected on the plane perpendicular to its axis.
+	* @param AxisOffset - Offset from the center of the capsule to the center of its top hemisphere.
+	* @param Radius - Radius of the capsule.
+	*/
+	static bool IsRingTouched(const FVector& RingLocation, float RingRadius, const FVector& Start, const FVector& Move, const FVector& FlatMove,
+		const FVector& AxisOffset, float Radius)
+	{
+		// Capsule location along the move closest to the ring, ignoring the capsule axis along which it's long.
+		const float FlatMoveSizeSquared = FlatMove.SizeSquared();
+		const float Time = FlatMoveSizeSquared > KINDA_SMALL_NUMBER ?
+			FMath::Clamp(((RingLocation - Start) | FlatMove) / FlatMoveSizeSquared, 0.0f, 1.0f) : 1.0f;
+		const FVector Center = Start + Move * Time;
+
+		const FVector ClosestPoint = FMath::ClosestPointOnSegment(RingLocation, Center - AxisOffset, Center + AxisOffset);
+		return FVector::DistSquared(ClosestPoint, RingLocation) <= FMath::Square(Radius + RingRadius);
+	}
+}
+
+
+void UDashRingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	CellSize = FMath::Max(DashRingSubsystemCVars::CellSize, 50.0f);
+	RenderActor = nullptr;
+	MaxRingRadius = 0.0f;
+	NumActiveRings = 0;
+	bRenderTreesPending = false;
+
+	// Scattered rings live in a fixed pool so scattering them never allocates.
+	const int32 PoolSize = FMath::Clamp(DashRingSubsystemCVars::ScatteredRingPoolSize, 0, 0xFFFF);
+
+	ScatterInstances = nullptr;
+	ScatterLocations.SetNumZeroed(PoolSize);
+	ScatterVelocities.SetNumZeroed(PoolSize);
+	ScatterGravities.SetNumZeroed(PoolSize);
+	ScatterPlanePoints.SetNumZeroed(PoolSize);
+	ScatterPlaneNormals.SetNumZeroed(PoolSize);
+	ScatterAges.SetNumZeroed(PoolSize);
+	ScatterParams.SetNumZeroed(PoolSize);
+	ScatterGenerations.SetNumZeroed(PoolSize);
+	ScatterTransforms.Init(FTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector), PoolSize);
+	ScatterSortedSlots.SetNumZeroed(PoolSize);
+	ScatterBucketStarts.SetNumZeroed(DashRingSubsystemStatics::NumScatterBuckets + 1);
+
+	ScatterSlots.Reset(PoolSize);
+	ScatterFreeSlots.Reset(PoolSize);
+	for (int32 Slot = PoolSize - 1; Slot >= 0; --Slot)
+	{
+		ScatterFreeSlots.Add(Slot);
+	}
+
+	NumScatteredRings = 0;
+	NextScatterTrace = 0;
+	MaxScatterRadius = 0.0f;
+	ScatterTraceDelegate.BindUObject(this, &UDashRingSubsystem::OnScatterTraceDone);
+}
+
+void UDashRingSubsystem::Deinitialize()
+{
+	RingLocations.Reset();
+	RingRadii.Reset();
+	RingTypeIndices.Reset();
+	RingInstances.Reset();
+	RingCollected.Reset();
+	RingTypes.Reset();
+	Cells.Reset();
+	RenderActor = nullptr;
+	NumActiveRings = 0;
+
+	ScatterInstances = nullptr;
+	ScatterLocations.Empty();
+	ScatterVelocities.Empty();
+	ScatterGravities.Empty();
+	ScatterPlanePoints.Empty();
+	ScatterPlaneNormals.Empty();
+	ScatterAges.Empty();
+	ScatterParams.Empty();
+	ScatterGenerations.Empty();
+	ScatterTransforms.Empty();
+	ScatterSortedSlots.Empty();
+	ScatterBucketStarts.Empty();
+	ScatterSlots.Empty();
+	ScatterFreeSlots.Empty();
+	NumScatteredRings = 0;
+	ScatterTraceDelegate.Unbind();
+
+	Super::Deinitialize();
+}
+
+int32 UDashRingSubsystem::AddRings(const TArray<FTransform>& Transforms, UStaticMesh* Mesh, UMaterialInterface* Material, float Radius)
+{
+	const int32 FirstRing = RingLocations.Num();
+	const int32 TypeIndex = FindOrAddRingType(Mesh, Material);
+	if (TypeIndex == INDEX_NONE)
+	{
+		return FirstRing;
+	}
+
+	UHierarchicalInstancedStaticMeshComponent* Instances = RingTypes[TypeIndex].Instances;
+	Instances->bAutoRebuildTreeOnInstanceChanges = false;
+
+	for (const FTransform& Transform : Transforms)
+	{
+		const int32 RingIndex = RingLocations.Add(Transform.GetLocation());
+		RingRadii.Add(Radius);
+		RingTypeIndices.Add(TypeIndex);
+		RingInstances.Add(Instances->AddInstanceWorldSpace(Transform));
+		RingCollected.Add(false);
+
+		Cells.FindOrAdd(GetCell(Transform.GetLocation())).Add(RingIndex);
+	}
+
+	MaxRingRadius = FMath::Max(MaxRingRadius, Radius);
+	NumActiveRings += Transforms.Num();
+	SET_DWORD_STAT(STAT_DashRingsActive, NumActiveRings);
+
+	// Patterns add their rings one after another at load; build the instance trees once, on the next tick.
+	if (!bRenderTreesPending)
+	{
+		bRenderTreesPending = true;
+		GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UDashRingSubsystem::BuildRenderTrees);
+	}
+
+	return FirstRing;
+}
+
+int32 UDashRingSubsystem::CollectRings(ACharacter* Character, const FVector& Start, const FVector& End, const FQuat& Rotation, float Radius, float HalfHeight)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DashRingCollection);
+
+	const FVector Axis = Rotation.GetAxisZ();
+	const FVector AxisOffset = Axis * FMath::Max(HalfHeight - Radius, 0.0f);
+	const FVector Move = End - Start;
+	const FVector FlatMove = FVector::VectorPlaneProject(Move, Axis);
+
+	// Cells overlapped by the bounds of the swept capsule.
+	const FBox Bounds = FBox(Start, Start).ExpandBy(HalfHeight + Radius + MaxRingRadius) + FBox(End, End).ExpandBy(HalfHeight + Radius + MaxRingRadius);
+	const FIntVector MinCell = GetCell(Bounds.Min);
+	const FIntVector MaxCell = GetCell(Bounds.Max);
+
+	int32 NumCollected = CollectScatteredRings(Start, End, Rotation, Radius, HalfHeight);
+	int32 NumFixedCollected = 0;
+
+	for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+			{
+				const TArray<int32>* CellRings = Cells.Find(FIntVector(X, Y, Z));
+				if (CellRings == nullptr)
+				{
+					continue;
+				}
+
+				for (const int32 RingIndex : *CellRings)
+				{
+					if (RingCollected[RingIndex])
+					{
+						continue;
+					}
+
+					const FVector& RingLocation = RingLocations[RingIndex];
+					if (!DashRingSubsystemStatics::IsRingTouched(RingLocation, RingRadii[RingIndex], Start, Move, FlatMove, AxisOffset, Radius))
+					{
+						continue;
+					}
+
+					// Hide the instance instead of removing it so instance indices stay valid.
+					RingCollected[RingIndex] = true;
+					RingTypes[RingTypeIndices[RingIndex]].Instances->UpdateInstanceTransform(RingInstances[RingIndex],
+						FTransform(FQuat::Identity, RingLocation, FVector::ZeroVector), true, true);
+
+					NumFixedCollected++;
+				}
+			}
+		}
+	}
+
+	if (NumFixedCollected > 0)
+	{
+		NumActiveRings -= NumFixedCollected;
+		SET_DWORD_STAT(STAT_DashRingsActive, NumActiveRings);
+	}
+
+	NumCollected += NumFixedCollected;
+	if (NumCollected > 0)
+	{
+		OnRingsCollected.Broadcast(Character, NumCollected);
+	}
+
+	return NumCollected;
+}
+
+int32 UDashRingSubsystem::GetNumActiveRings() const
+{
+	return NumActiveRings;
+}
+
+int32 UDashRingSubsystem::FindOrAddRingType(UStaticMesh* Mesh, UMaterialInterface* Material)
+{
+	if (Mesh == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 ExistingIndex = RingTypes.IndexOfByPredicate([Mesh, Material](const FDashRingType& RingType)
+	{
+		return RingType.Mesh == Mesh && RingType.Material == Material;
+	});
+
+	if (ExistingIndex != INDEX_NONE)
+	{
+		return ExistingIndex;
+	}
+
+	AActor* Actor = GetRenderActor();
+
+	FDashRingType RingType;
+	RingType.Mesh = Mesh;
+	RingType.Material = Material;
+	RingType.Instances = NewObject<UHierarchicalInstancedStaticMeshComponent>(Actor);
+	RingType.Instances->SetStaticMesh(Mesh);
+	RingType.Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	RingType.Instances->SetCanEverAffectNavigation(false);
+	RingType.Instances->bAutoRebuildTreeOnInstanceChanges = false;
+
+	if (Material != nullptr)
+	{
+		for (int32 MaterialIndex = 0; MaterialIndex < RingType.Instances->GetNumMaterials(); ++MaterialIndex)
+		{
+			RingType.Instances->SetMaterial(MaterialIndex, Material);
+		}
+	}
+
+	RingType.Instances->SetupAttachment(Actor->GetRootComponent());
+	RingType.Instances->RegisterComponent();
+	Actor->AddInstanceComponent(RingType.Instances);
+
+	return RingTypes.Add(RingType);
+}
+
+AActor* UDashRingSubsystem::GetRenderActor()
+{
+	if (RenderActor == nullptr)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.Name = TEXT("DashRings");
+		SpawnParameters.ObjectFlags = RF_Transient;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		RenderActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+
+		USceneComponent* Root = NewObject<USceneComponent>(RenderActor, TEXT("Root"));
+		RenderActor->SetRootComponent(Root);
+		Root->RegisterComponent();
+	}
+
+	return RenderActor;
+}
+
+FIntVector UDashRingSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void UDashRingSubsystem::BuildRenderTrees()
+{
+	bRenderTreesPending = false;
+
+	for (FDashRingType& RingType : RingTypes)
+	{
+		if (RingType.Instances != nullptr)
+		{
+			RingType.Instances->BuildTreeIfOutdated(true, false);
+
+			// Collected rings update their instance later.
+			RingType.Instances->bAutoRebuildTreeOnInstanceChanges = true;
+		}
+	}
+}
+
+int32 UDashRingSubsystem::ScatterRings(UDashCharacterMovementComponent* Source, int32 Count, const FDashRingScatterSettings& Settings)
+{
+	if (Source == nullptr || Source->UpdatedComponent == nullptr || Settings.Mesh == nullptr)
+	{
+		return 0;
+	}
+
+	Count = FMath::Min(Count, ScatterFreeSlots.Num());
+	if (Count <= 0)
+	{
+		return 0;
+	}
+
+	InitScatteredRings(Settings);
+
+	const FVector Location = Source->UpdatedComponent->GetComponentLocation();
+	const FVector Gravity = Source->GetGravity();
+	const FVector Up = -Source->GetGravityDirection();
+
+	FVector AxisX, AxisY;
+	Up.FindBestAxisVectors(AxisX, AxisY);
+
+	// Rings bounce on the floor of the character until traces find better planes.
+	const bool bHasFloor = Source->CurrentFloor.IsWalkableFloor();
+	const FVector PlanePoint = bHasFloor ? Source->CurrentFloor.HitResult.ImpactPoint : Location;
+	const FVector PlaneNormal = bHasFloor ? Source->CurrentFloor.HitResult.ImpactNormal : FVector::ZeroVector;
+
+	FDashScatteredRingParams Params;
+	Params.Lifetime = Settings.Lifetime;
+	Params.FadeTime = FMath::Max(Settings.FadeTime, KINDA_SMALL_NUMBER);
+	Params.PickupDelay = Settings.PickupDelay;
+	Params.Radius = Settings.Radius;
+	Params.Restitution = 1.0f + Settings.Bounciness;
+	Params.CollisionChannel = Settings.CollisionChannel;
+	MaxScatterRadius = FMath::Max(MaxScatterRadius, Settings.Radius);
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const int32 Slot = ScatterFreeSlots.Pop(false);
+		ScatterSlots.Add(Slot);
+
+		// Circle around the character; every other ring is slower so they spread into two circles.
+		const float Angle = 2.0f * PI * Index / Count;
+		const float SpeedScale = (Index & 1) ? 0.6f : 1.0f;
+
+		ScatterLocations[Slot] = Location;
+		ScatterVelocities[Slot] = (AxisX * FMath::Cos(Angle) + AxisY * FMath::Sin(Angle)) * Settings.Speed * SpeedScale + Up * Settings.UpSpeed * SpeedScale;
+		ScatterGravities[Slot] = Gravity;
+		ScatterPlanePoints[Slot] = PlanePoint;
+		ScatterPlaneNormals[Slot] = PlaneNormal;
+		ScatterAges[Slot] = 0.0f;
+		ScatterParams[Slot] = Params;
+		ScatterGenerations[Slot]++;
+
+		ScatterInstances->SetCustomDataValue(Slot, 0, 1.0f, false);
+	}
+
+	NumScatteredRings = ScatterSlots.Num();
+	SET_DWORD_STAT(STAT_DashRingsScattered, NumScatteredRings);
+
+	return Count;
+}
+
+void UDashRingSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DashScatteredRingsTick);
+
+	UWorld* World = GetWorld();
+
+	// Refresh the bounce planes of a few rings, round-robin; results arrive on a later frame.
+	const int32 NumTraces = FMath::Min(DashRingSubsystemCVars::ScatteredRingTracesPerTick, ScatterSlots.Num());
+	if (NumTraces > 0)
+	{
+		const float Lookahead = DashRingSubsystemCVars::ScatteredRingTraceLookahead;
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(DashScatteredRingTrace), false);
+
+		for (int32 Index = 0; Index < NumTraces; ++Index)
+		{
+			NextScatterTrace = (NextScatterTrace + 1) % ScatterSlots.Num();
+			const int32 Slot = ScatterSlots[NextScatterTrace];
+
+			const FVector& Start = ScatterLocations[Slot];
+			const FVector End = Start + (ScatterVelocities[Slot] + ScatterGravities[Slot] * (0.5f * Lookahead)) * Lookahead +
+				ScatterGravities[Slot].GetSafeNormal() * ScatterParams[Slot].Radius;
+
+			World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, ScatterParams[Slot].CollisionChannel, QueryParams,
+				FCollisionResponseParams::DefaultResponseParam, &ScatterTraceDelegate, (uint32)Slot | ((uint32)ScatterGenerations[Slot] << 16));
+		}
+	}
+
+	// Iterate backwards so expired rings are removed in place.
+	for (int32 Index = ScatterSlots.Num() - 1; Index >= 0; --Index)
+	{
+		const int32 Slot = ScatterSlots[Index];
+		const FDashScatteredRingParams& Params = ScatterParams[Slot];
+
+		float& Age = ScatterAges[Slot];
+		Age += DeltaTime;
+
+		if (Age >= Params.Lifetime)
+		{
+			ScatterTransforms[Slot].SetScale3D(FVector::ZeroVector);
+			ScatterSlots.RemoveAtSwap(Index, 1, false);
+			ScatterFreeSlots.Add(Slot);
+			continue;
+		}
+
+		FVector& Velocity = ScatterVelocities[Slot];
+		FVector& Location = ScatterLocations[Slot];
+		Velocity += ScatterGravities[Slot] * DeltaTime;
+		Location += Velocity * DeltaTime;
+
+		// Bounce off the plane, reflecting the velocity into it.
+		const FVector& PlaneNormal = ScatterPlaneNormals[Slot];
+		const float Distance = ((Location - ScatterPlanePoints[Slot]) | PlaneNormal) - Params.Radius;
+		if (Distance < 0.0f && !PlaneNormal.IsZero())
+		{
+			Location -= PlaneNormal * Distance;
+
+			const float NormalSpeed = Velocity | PlaneNormal;
+			if (NormalSpeed < 0.0f)
+			{
+				Velocity -= PlaneNormal * (NormalSpeed * Params.Restitution);
+			}
+		}
+
+		// Shrink and fade out at the end of the lifetime.
+		const float Fade = FMath::Min((Params.Lifetime - Age) / Params.FadeTime, 1.0f);
+		if (Fade < 1.0f)
+		{
+			ScatterInstances->SetCustomDataValue(Slot, 0, Fade, false);
+		}
+
+		ScatterTransforms[Slot] = FTransform(FQuat::Identity, Location, FVector(Fade));
+	}
+
+	NumScatteredRings = ScatterSlots.Num();
+	NextScatterTrace = NumScatteredRings > 0 ? NextScatterTrace % NumScatteredRings : 0;
+	MaxScatterRadius = NumScatteredRings > 0 ? MaxScatterRadius : 0.0f;
+	SET_DWORD_STAT(STAT_DashRingsScattered, NumScatteredRings);
+
+	ScatterInstances->BatchUpdateInstancesTransforms(0, ScatterTransforms, true, true, true);
+
+	BuildScatterGrid();
+}
+
+bool UDashRingSubsystem::IsTickable() const
+{
+	return NumScatteredRings > 0 && ScatterInstances != nullptr && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+UWorld* UDashRingSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UDashRingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDashRingSubsystem, STATGROUP_Tickables);
+}
+
+void UDashRingSubsystem::InitScatteredRings(const FDashRingScatterSettings& Settings)
+{
+	if (ScatterInstances == nullptr)
+	{
+		AActor* Actor = GetRenderActor();
+
+		// Plain instanced component: every instance moves each frame, so a tree would only be rebuilt for nothing.
+		ScatterInstances = NewObject<UInstancedStaticMeshComponent>(Actor);
+		ScatterInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		ScatterInstances->SetCanEverAffectNavigation(false);
+		ScatterInstances->NumCustomDataFloats = 1;
+		ScatterInstances->SetupAttachment(Actor->GetRootComponent());
+		ScatterInstances->RegisterComponent();
+		Actor->AddInstanceComponent(ScatterInstances);
+
+		// Every slot owns an instance for the whole game, scaled to zero while free.
+		for (const FTransform& Transform : ScatterTransforms)
+		{
+			ScatterInstances->AddInstanceWorldSpace(Transform);
+		}
+	}
+
+	// Rings in flight share the instanced component; keep their look until they're gone.
+	if (NumScatteredRings > 0)
+	{
+		return;
+	}
+
+	if (ScatterInstances->GetStaticMesh() != Settings.Mesh)
+	{
+		ScatterInstances->SetStaticMesh(Settings.Mesh);
+	}
+
+	if (Settings.Material != nullptr)
+	{
+		for (int32 MaterialIndex = 0; MaterialIndex < ScatterInstances->GetNumMaterials(); ++MaterialIndex)
+		{
+			ScatterInstances->SetMaterial(MaterialIndex, Settings.Material);
+		}
+	}
+}
+
+int32 UDashRingSubsystem::CollectScatteredRings(const FVector& Start, const FVector& End, const FQuat& Rotation, float Radius, float HalfHeight)
+{
+	if (NumScatteredRings == 0)
+	{
+		return 0;
+	}
+
+	const FVector Axis = Rotation.GetAxisZ();
+	const FVector AxisOffset = Axis * FMath::Max(HalfHeight - Radius, 0.0f);
+	const FVector Move = End - Start;
+	const FVector FlatMove = FVector::VectorPlaneProject(Move, Axis);
+
+	int32 NumCollected = 0;
+
+	auto CollectSlot = [&](int32 Slot)
+	{
+		const FDashScatteredRingParams& Params = ScatterParams[Slot];
+		const float Age = ScatterAges[Slot];
+		if (Age >= Params.PickupDelay && Age < Params.Lifetime &&
+			DashRingSubsystemStatics::IsRingTouched(ScatterLocations[Slot], Params.Radius, Start, Move, FlatMove, AxisOffset, Radius))
+		{
+			// Expire the ring; the next tick frees its slot and hides its instance.
+			ScatterAges[Slot] = Params.Lifetime;
+			NumCollected++;
+		}
+	};
+
+	// Cells overlapped by the bounds of the swept capsule; too many cells cover every bucket anyway.
+	const FBox Bounds = FBox(Start, Start).ExpandBy(HalfHeight + Radius + MaxScatterRadius) +
+		FBox(End, End).ExpandBy(HalfHeight + Radius + MaxScatterRadius);
+	const FIntVector MinCell = GetCell(Bounds.Min);
+	const FIntVector MaxCell = GetCell(Bounds.Max);
+	const FIntVector NumCells = MaxCell - MinCell + FIntVector(1, 1, 1);
+
+	if (NumCells.X * NumCells.Y * NumCells.Z > DashRingSubsystemStatics::NumScatterBuckets)
+	{
+		for (const int32 Slot : ScatterSlots)
+		{
+			CollectSlot(Slot);
+		}
+	}
+	else
+	{
+		// Buckets shared by several cells are tested more than once; collected rings are expired so they're only counted once.
+		for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+				{
+					const int32 Bucket = GetScatterBucket(FVector(X + 0.5f, Y + 0.5f, Z + 0.5f) * CellSize);
+					for (int32 Index = ScatterBucketStarts[Bucket]; Index < ScatterBucketStarts[Bucket + 1]; ++Index)
+					{
+						CollectSlot(ScatterSortedSlots[Index]);
+					}
+				}
+			}
+		}
+	}
+
+	return NumCollected;
+}
+
+int32 UDashRingSubsystem::GetScatterBucket(const FVector& Location) const
+{
+	const FIntVector Cell = GetCell(Location);
+	return (((uint32)Cell.X * 73856093u) ^ ((uint32)Cell.Y * 19349663u) ^ ((uint32)Cell.Z * 83492791u)) & (DashRingSubsystemStatics::NumScatterBuckets - 1);
+}
+
+void UDashRingSubsystem::BuildScatterGrid()
+{
+	// Counting sort of the used slots by bucket, into preallocated arrays.
+	int32 Cursors[DashRingSubsystemStatics::NumScatterBuckets];
+	FMemory::Memzero(Cursors);
+
+	for (const int32 Slot : ScatterSlots)
+	{
+		Cursors[GetScatterBucket(ScatterLocations[Slot])]++;
+	}
+
+	int32 Start = 0;
+	for (int32 Bucket = 0; Bucket < DashRingSubsystemStatics::NumScatterBuckets; ++Bucket)
+	{
+		const int32 Count = Cursors[Bucket];
+		ScatterBucketStarts[Bucket] = Start;
+		Cursors[Bucket] = Start;
+		Start += Count;
+	}
+	ScatterBucketStarts[DashRingSubsystemStatics::NumScatterBuckets] = Start;
+
+	for (const int32 Slot : ScatterSlots)
+	{
+		ScatterSortedSlots[Cursors[GetScatterBucket(ScatterLocations[Slot])]++] = Slot;
+	}
+}
+
+void UDashRingSubsystem::OnScatterTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceData)
+{
+	const int32 Slot = TraceData.UserData & 0xFFFF;
+	const uint16 Generation = (uint16)(TraceData.UserData >> 16);
+
+	// Ignore results of rings that expired since the trace.
+	if (!ScatterAges.IsValidIndex(Slot) || ScatterGenerations[Slot] != Generation || ScatterAges[Slot] >= ScatterParams[Slot].Lifetime)
+	{
+		return;
+	}
+
+	if (TraceData.OutHits.Num() > 0 && TraceData.OutHits[0].bBlockingHit)
+	{
+		ScatterPlanePoints[Slot] = TraceData.OutHits[0].ImpactPoint;
+		ScatterPlaneNormals[Slot] = TraceData.OutHits[0].ImpactNormal;
+	}
+	else
+	{
+		// Nothing ahead; fall freely until a later trace finds something.
+		ScatterPlaneNormals[Slot] = FVector::ZeroVector;
+	}
+}
+
+
+ADashRingPattern::ADashRingPattern()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+	Spline = CreateDefaultSubobject<USplineComponent>(TEXT("Spline"));
+	Spline->SetupAttachment(RootComponent);
+
+#if WITH_EDITORONLY_DATA
+	Preview = CreateEditorOnlyDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("Preview"));
+	if (Preview != nullptr)
+	{
+		Preview->SetupAttachment(RootComponent);
+		Preview->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		Preview->SetCanEverAffectNavigation(false);
+		Preview->bHiddenInGame = true;
+	}
+#endif
+
+	Shape = EDashRingPatternShape::Line;
+	Count = 5;
+	Spacing = 150.0f;
+	PatternRadius = 300.0f;
+	ArcAngle = 180.0f;
+	RingMesh = nullptr;
+	RingMaterial = nullptr;
+	RingRadius = 40.0f;
+}
+
+void ADashRingPattern::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+#if WITH_EDITORONLY_DATA
+	if (Preview != nullptr)
+	{
+		Preview->ClearInstances();
+		Preview->SetStaticMesh(RingMesh);
+		Preview->SetMaterial(0, RingMaterial);
+
+		TArray<FTransform> Transforms;
+		GetRingTransforms(Transforms);
+
+		for (const FTransform& RingTransform : Transforms)
+		{
+			Preview->AddInstanceWorldSpace(RingTransform);
+		}
+	}
+#endif
+}
+
+void ADashRingPattern::BeginPlay()
+{
+	Super::BeginPlay();
+
+#if WITH_EDITORONLY_DATA
+	if (Preview != nullptr)
+	{
+		Preview->ClearInstances();
+	}
+#endif
+
+	if (UDashRingSubsystem* RingSubsystem = GetWorld()->GetSubsystem<UDashRingSubsystem>())
+	{
+		TArray<FTransform> Transforms;
+		GetRingTransforms(Transforms);
+
+		RingSubsystem->AddRings(Transforms, RingMesh, RingMaterial, RingRadius);
+	}
+}
+
+void ADashRingPattern::GetRingTransforms(TArray<FTransform>& OutTransforms) const
+{
+	const FTransform& ActorTransform = GetActorTransform();
+
+	switch (Shape)
+	{
+	case EDashRingPatternShape::Single:
+		OutTransforms.Add(ActorTransform);
+		break;
+
+	case EDashRingPatternShape::Line:
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			OutTransforms.Add(FTransform(FVector(Spacing * Index, 0.0f, 0.0f)) * ActorTransform);
+		}
+		break;
+
+	case EDashRingPatternShape::Circle:
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			const float Angle = 2.0f * PI * Index / Count;
+			OutTransforms.Add(FTransform(FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * PatternRadius) * ActorTransform);
+		}
+		break;
+
+	case EDashRingPatternShape::Arc:
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			// Arc starts at the actor and bends up, centered above it.
+			const float Angle = FMath::DegreesToRadians(ArcAngle) * (Count > 1 ? (float)Index / (Count - 1) : 0.0f);
+			OutTransforms.Add(FTransform(FVector(FMath::Sin(Angle), 0.0f, 1.0f - FMath::Cos(Angle)) * PatternRadius) * ActorTransform);
+		}
+		break;
+
+	case EDashRingPatternShape::Spline:
+	{
+		const float Length = Spline->GetSplineLength();
+		const int32 NumRings = Spacing > 0.0f ? FMath::FloorToInt(Length / Spacing) + 1 : Count;
+		const float Step = Spacing > 0.0f ? Spacing : (NumRings > 1 ? Length / (NumRings - 1) : 0.0f);
+
+		for (int32 Index = 0; Index < NumRings; ++Index)
+		{
+			OutTransforms.Add(Spline->GetTransformAtDistanceAlongSpline(Step * Index, ESplineCoordinateSpace::World, true));
+		}
+		break;
+	}
+	}
+}
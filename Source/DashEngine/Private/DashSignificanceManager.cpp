@@ -0,0 +1,402 @@
+////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2019 GalaxySoftware Studio
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#include "DashSignificanceManager.h"
+#include "DashEngine.h"
+
+#include "Camera/PlayerCameraManager.h"
+#include "DashActorComponent.h"
+#include "DashTickManager.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Scalability.h"
+
+DECLARE_CYCLE_STAT(TEXT("Dash Significance"), STAT_DashSignificance, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash Significance Full"), STAT_DashSignificanceFull, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash Significance Reduced"), STAT_DashSignificanceReduced, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash Significance Minimal"), STAT_DashSignificanceMinimal, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash Significance Dormant"), STAT_DashSignificanceDormant, STATGROUP_Character);
+
+// CVars.
+namespace DashSignificanceManagerCVars
+{
+	static int32 ScalabilityLevel = -1;
+	FAutoConsoleVariableRef CVarScalabilityLevel(
+		TEXT("p.DashSignificanceLevel"),
+		ScalabilityLevel,
+		TEXT("Scalability level gameplay significance uses; read when a world starts.\n")
+		TEXT("-1: From the engine quality levels, 0: Low, 1: Medium, 2: High, 3: Epic, 4: Cinematic"),
+		ECVF_Scalability);
+}
+
+// Statics.
+namespace DashSignificanceManagerStatics
+{
+	/** Fraction of a threshold an object must come back under to become more significant again, so it doesn't flicker at the boundary. */
+	static const float Hysteresis = 0.9f;
+}
+
+
+void UDashSignificanceManager::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// View distance and effects quality are the engine levels closest to how far gameplay detail reaches.
+	int32 Level = DashSignificanceManagerCVars::ScalabilityLevel;
+	if (Level < 0)
+	{
+		const Scalability::FQualityLevels QualityLevels = Scalability::GetQualityLevels();
+		Level = FMath::Min(QualityLevels.ViewDistanceQuality, QualityLevels.EffectsQuality);
+	}
+
+	ScalabilityLevel = (EDashScalabilityLevel)FMath::Clamp(Level, (int32)EDashScalabilityLevel::Low, (int32)EDashScalabilityLevel::Cinematic);
+	UpdateLevelSettings();
+	bLevelChanged = false;
+}
+
+void UDashSignificanceManager::Deinitialize()
+{
+	Actors.Empty();
+	Significances.Empty();
+	ApplyTickIntervals.Empty();
+	ActorIndices.Empty();
+	Viewers.Empty();
+
+	Super::Deinitialize();
+}
+
+void UDashSignificanceManager::RegisterActor(AActor* Actor, bool bApplyTickInterval)
+{
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	// The entry may also belong to a destroyed actor at the same address.
+	if (const int32* Index = ActorIndices.Find(Actor))
+	{
+		Actors[*Index] = Actor;
+		ApplyTickIntervals[*Index] = bApplyTickInterval;
+		return;
+	}
+
+	ActorIndices.Add(Actor, Actors.Num());
+	Actors.Add(Actor);
+	Significances.Add(EDashSignificance::Full);
+	ApplyTickIntervals.Add(bApplyTickInterval);
+}
+
+void UDashSignificanceManager::UnregisterActor(AActor* Actor)
+{
+	const int32* Index = Actor != nullptr ? ActorIndices.Find(Actor) : nullptr;
+	if (Index == nullptr)
+	{
+		return;
+	}
+
+	if (ApplyTickIntervals[*Index] && Significances[*Index] != EDashSignificance::Full)
+	{
+		ApplyTickInterval(Actor, EDashSignificance::Full);
+	}
+
+	RemoveActorAt(*Index);
+}
+
+bool UDashSignificanceManager::GetSignificance(const AActor* Actor, EDashSignificance& OutSignificance) const
+{
+	const int32* Index = ActorIndices.Find(Actor);
+	if (Index == nullptr)
+	{
+		return false;
+	}
+
+	OutSignificance = Significances[*Index];
+	return true;
+}
+
+EDashSignificance UDashSignificanceManager::RateLocation(const FVector& Location) const
+{
+	return GetSignificanceAt(GetEffectiveDistance(Location), EDashSignificance::Full);
+}
+
+bool UDashSignificanceManager::ShouldCullFX(const FVector& Location) const
+{
+	return bHasLevelSettings && Viewers.Num() > 0 && RateLocation(Location) >= LevelSettings.FXCullSignificance;
+}
+
+void UDashSignificanceManager::SetScalabilityLevel(EDashScalabilityLevel Level)
+{
+	if (Level != ScalabilityLevel)
+	{
+		ScalabilityLevel = Level;
+		UpdateLevelSettings();
+		bLevelChanged = true;
+	}
+}
+
+EDashScalabilityLevel UDashSignificanceManager::GetScalabilityLevel() const
+{
+	return ScalabilityLevel;
+}
+
+void UDashSignificanceManager::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DashSignificance);
+
+	UpdateViewers();
+
+	int32 NumPerSignificance[4] = { 0, 0, 0, 0 };
+
+	for (int32 Index = Actors.Num() - 1; Index >= 0; --Index)
+	{
+		AActor* Actor = Actors[Index].Get();
+		if (Actor == nullptr)
+		{
+			RemoveActorAt(Index);
+			continue;
+		}
+
+		// Nothing is rated without local viewers (e.g. on dedicated servers), and players are always significant.
+		EDashSignificance Significance = EDashSignificance::Full;
+		const APawn* Pawn = Cast<APawn>(Actor);
+		if (bHasLevelSettings && Viewers.Num() > 0 && (Pawn == nullptr || !Pawn->IsLocallyControlled()))
+		{
+			Significance = GetSignificanceAt(GetEffectiveDistance(Actor->GetActorLocation()), Significances[Index]);
+		}
+
+		NumPerSignificance[(int32)Significance]++;
+
+		if (Significance == Significances[Index] && !bLevelChanged)
+		{
+			continue;
+		}
+
+		const bool bChanged = Significance != Significances[Index];
+		Significances[Index] = Significance;
+
+		if (ApplyTickIntervals[Index])
+		{
+			ApplyTickInterval(Actor, Significance);
+		}
+
+		if (bChanged)
+		{
+			OnSignificanceChanged.Broadcast(Actor, Significance);
+		}
+	}
+
+	bLevelChanged = false;
+
+	INC_DWORD_STAT_BY(STAT_DashSignificanceFull, NumPerSignificance[(int32)EDashSignificance::Full]);
+	INC_DWORD_STAT_BY(STAT_DashSignificanceReduced, NumPerSignificance[(int32)EDashSignificance::Reduced]);
+	INC_DWORD_STAT_BY(STAT_DashSignificanceMinimal, NumPerSignificance[(int32)EDashSignificance::Minimal]);
+	INC_DWORD_STAT_BY(STAT_DashSignificanceDormant, NumPerSignificance[(int32)EDashSignificance::Dormant]);
+}
+
+bool UDashSignificanceManager::IsTickable() const
+{
+	return Actors.Num() > 0 && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+UWorld* UDashSignificanceManager::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UDashSignificanceManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDashSignificanceManager, STATGROUP_Tickables);
+}
+
+void UDashSignificanceManager::UpdateLevelSettings()
+{
+	// Copied, since editing the project settings reallocates their array.
+	const FDashSignificanceLevel* Settings = GetDefault<UDashEngineSettings>()->GetSignificanceLevel(ScalabilityLevel);
+	bHasLevelSettings = Settings != nullptr;
+	LevelSettings = bHasLevelSettings ? *Settings : FDashSignificanceLevel();
+}
+
+void UDashSignificanceManager::UpdateViewers()
+{
+	const float LookaheadTime = GetDefault<UDashEngineSettings>()->SignificanceLookaheadTime;
+
+	Viewers.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController == nullptr || !PlayerController->IsLocalController() || PlayerController->PlayerCameraManager == nullptr)
+		{
+			continue;
+		}
+
+		const APlayerCameraManager* CameraManager = PlayerController->PlayerCameraManager;
+		const AActor* ViewTarget = PlayerController->GetViewTarget();
+		const FVector Velocity = ViewTarget != nullptr ? ViewTarget->GetVelocity() : FVector::ZeroVector;
+
+		FDashSignificanceViewer& Viewer = Viewers.AddDefaulted_GetRef();
+		Viewer.Location = CameraManager->GetCameraLocation();
+		Viewer.Direction = CameraManager->GetCameraRotation().Vector();
+		Viewer.MoveDirection = Velocity.GetSafeNormal();
+		Viewer.LookaheadDistance = Velocity.Size() * LookaheadTime;
+		Viewer.CosHalfFOV = FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(CameraManager->GetFOVAngle(), 1.0f, 170.0f) * 0.5f));
+	}
+}
+
+float UDashSignificanceManager::GetEffectiveDistance(const FVector& Location) const
+{
+	const UDashEngineSettings* Settings = GetDefault<UDashEngineSettings>();
+	float Distance = Viewers.Num() > 0 ? BIG_NUMBER : 0.0f;
+
+	for (const FDashSignificanceViewer& Viewer : Viewers)
+	{
+		const FVector ToLocation = Location - Viewer.Location;
+		const float DistanceSquared = ToLocation.SizeSquared();
+		float ViewerDistance = FMath::Sqrt(DistanceSquared);
+
+		// Ahead of the movement, the lookahead distance counts as near; behind, distances are stretched.
+		if (!Viewer.MoveDirection.IsZero())
+		{
+			const float Along = ToLocation | Viewer.MoveDirection;
+			const float AcrossSquared = FMath::Max(DistanceSquared - Along * Along, 0.0f);
+			const float AdjustedAlong = Along >= 0.0f ? FMath::Max(Along - Viewer.LookaheadDistance, 0.0f) : -Along * Settings->SignificanceBehindDistanceScale;
+
+			ViewerDistance = FMath::Sqrt(AdjustedAlong * AdjustedAlong + AcrossSquared);
+		}
+
+		if (DistanceSquared > KINDA_SMALL_NUMBER && (ToLocation | Viewer.Direction) < Viewer.CosHalfFOV * FMath::Sqrt(DistanceSquared))
+		{
+			ViewerDistance *= Settings->SignificanceOffscreenDistanceScale;
+		}
+
+		Distance = FMath::Min(Distance, ViewerDistance);
+	}
+
+	return Distance;
+}
+
+EDashSignificance UDashSignificanceManager::GetSignificanceAt(float Distance, EDashSignificance Current) const
+{
+	if (!bHasLevelSettings)
+	{
+		return EDashSignificance::Full;
+	}
+
+	const float Thresholds[] = { LevelSettings.ReducedDistance, LevelSettings.MinimalDistance, LevelSettings.DormantDistance };
+
+	// Each boundary the object is already beyond must be crossed back by a margin.
+	int32 Significance = 0;
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(Thresholds); ++Index)
+	{
+		const float Threshold = Thresholds[Index] * ((int32)Current > Index ? DashSignificanceManagerStatics::Hysteresis : 1.0f);
+		if (Distance >= Threshold)
+		{
+			Significance = Index + 1;
+		}
+	}
+
+	return (EDashSignificance)Significance;
+}
+
+void UDashSignificanceManager::RemoveActorAt(int32 Index)
+{
+	// Destroyed actors can't be looked up by key anymore; find their entry by index.
+	for (auto It = ActorIndices.CreateIterator(); It; ++It)
+	{
+		if (It.Value() == Index)
+		{
+			It.RemoveCurrent();
+			break;
+		}
+	}
+
+	// Move the last actor into the freed index.
+	const int32 LastIndex = Actors.Num() - 1;
+	if (Index != LastIndex)
+	{
+		for (auto It = ActorIndices.CreateIterator(); It; ++It)
+		{
+			if (It.Value() == LastIndex)
+			{
+				It.Value() = Index;
+				break;
+			}
+		}
+
+		Actors[Index] = Actors[LastIndex];
+		Significances[Index] = Significances[LastIndex];
+		ApplyTickIntervals[Index] = ApplyTickIntervals[LastIndex];
+	}
+
+	Actors.RemoveAt(LastIndex, 1, false);
+	Significances.RemoveAt(LastIndex, 1, false);
+	ApplyTickIntervals.RemoveAt(LastIndex);
+}
+
+void UDashSignificanceManager::ApplyTickInterval(AActor* Actor, EDashSignificance Significance) const
+{
+	float TickInterval = 0.0f;
+	if (bHasLevelSettings)
+	{
+		switch (Significance)
+		{
+		case EDashSignificance::Reduced:
+			TickInterval = LevelSettings.ReducedTickInterval;
+			break;
+
+		case EDashSignificance::Minimal:
+			TickInterval = LevelSettings.MinimalTickInterval;
+			break;
+
+		case EDashSignificance::Dormant:
+			TickInterval = LevelSettings.DormantTickInterval;
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	// Never tick faster than the archetypes were set to.
+	if (const AActor* Archetype = Cast<AActor>(Actor->GetArchetype()))
+	{
+		Actor->SetActorTickInterval(FMath::Max(Archetype->PrimaryActorTick.TickInterval, TickInterval));
+	}
+
+	UDashTickManager* TickManager = GetWorld()->GetSubsystem<UDashTickManager>();
+
+	for (UActorComponent* Component : Actor->GetComponents())
+	{
+		// Batched components ignore the interval of their own tick function.
+		UDashActorComponent* DashComponent = Cast<UDashActorComponent>(Component);
+		if (DashComponent != nullptr && DashComponent->IsTickBatched() && TickManager != nullptr)
+		{
+			TickManager->SetComponentTickInterval(DashComponent, TickInterval);
+		}
+		else if (Component != nullptr && Component->PrimaryComponentTick.bCanEverTick)
+		{
+			const UActorComponent* Archetype = Cast<UActorComponent>(Component->GetArchetype());
+			Component->SetComponentTickInterval(FMath::Max(Archetype != nullptr ? Archetype->PrimaryComponentTick.TickInterval : 0.0f, TickInterval));
+		}
+	}
+}
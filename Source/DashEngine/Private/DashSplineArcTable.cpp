@@ -0,0 +1,221 @@
+////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2019 GalaxySoftware Studio
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#include "DashSplineArcTable.h"
+#include "DashEngine.h"
+
+#include "Algo/BinarySearch.h"
+#include "Components/SplineComponent.h"
+
+
+FDashSplineArcTable::FDashSplineArcTable()
+	: MinSampleDistance(1.0f), Length(0.0f), bClosedLoop(false)
+{
+}
+
+void FDashSplineArcTable::Build(const USplineComponent* InSpline, float InSampleDistance)
+{
+	Reset();
+
+	if (InSpline == nullptr || InSpline->GetNumberOfSplinePoints() < 2)
+	{
+		return;
+	}
+
+	Spline = InSpline;
+	bClosedLoop = InSpline->IsClosedLoop();
+
+	// Scale the samples, so distances and closest points are measured like in world space.
+	const FVector Scale = InSpline->GetComponentTransform().GetScale3D();
+	const float LocalLength = InSpline->GetSplineLength();
+
+	// Uniform samples in local space, close enough along the most scaled axis; the last one lands exactly on the end of the spline.
+	const int32 NumSegments = FMath::Max(1, FMath::CeilToInt(LocalLength * FMath::Max(Scale.GetAbsMax(), KINDA_SMALL_NUMBER) / FMath::Max(InSampleDistance, 1.0f)));
+	const float LocalSampleDistance = LocalLength / NumSegments;
+
+	Locations.SetNumUninitialized(NumSegments + 1);
+	Directions.SetNumUninitialized(NumSegments + 1);
+	UpVectors.SetNumUninitialized(NumSegments + 1);
+	Distances.SetNumUninitialized(NumSegments + 1);
+
+	FVector LocalLocation = FVector::ZeroVector;
+	MinSampleDistance = BIG_NUMBER;
+	for (int32 Index = 0; Index <= NumSegments; ++Index)
+	{
+		const float Distance = FMath::Min(Index * LocalSampleDistance, LocalLength);
+		const FVector PreviousLocalLocation = LocalLocation;
+		LocalLocation = InSpline->GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::Local);
+
+		Locations[Index] = LocalLocation * Scale;
+		Directions[Index] = (InSpline->GetDirectionAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::Local) * Scale).GetSafeNormal();
+		UpVectors[Index] = (InSpline->GetUpVectorAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::Local) * Scale).GetSafeNormal();
+
+		if (Index == 0)
+		{
+			Distances[Index] = 0.0f;
+			continue;
+		}
+
+		// Arc length of the segment, stretched like its chord.
+		const float ChordLength = FVector::Dist(PreviousLocalLocation, LocalLocation);
+		const float SegmentLength = ChordLength > KINDA_SMALL_NUMBER ?
+			(Distance - (Index - 1) * LocalSampleDistance) * FVector::Dist(Locations[Index - 1], Locations[Index]) / ChordLength : 0.0f;
+
+		Distances[Index] = Distances[Index - 1] + SegmentLength;
+		MinSampleDistance = FMath::Min(MinSampleDistance, SegmentLength);
+	}
+
+	Length = Distances.Last();
+	MinSampleDistance = FMath::Max(MinSampleDistance, KINDA_SMALL_NUMBER);
+}
+
+void FDashSplineArcTable::Reset()
+{
+	Spline.Reset();
+	Locations.Reset();
+	Directions.Reset();
+	UpVectors.Reset();
+	Distances.Reset();
+	Length = 0.0f;
+	bClosedLoop = false;
+}
+
+bool FDashSplineArcTable::IsValid() const
+{
+	return Locations.Num() > 1 && Spline.IsValid();
+}
+
+float FDashSplineArcTable::WrapDistance(float Distance) const
+{
+	if (bClosedLoop && Length > KINDA_SMALL_NUMBER)
+	{
+		Distance = FMath::Fmod(Distance, Length);
+		return Distance < 0.0f ? Distance + Length : Distance;
+	}
+
+	return FMath::Clamp(Distance, 0.0f, Length);
+}
+
+FTransform FDashSplineArcTable::GetTransform() const
+{
+	const FTransform& Transform = Spline->GetComponentTransform();
+	return FTransform(Transform.GetRotation(), Transform.GetTranslation());
+}
+
+void FDashSplineArcTable::GetSegment(float Distance, int32& OutIndex, float& OutAlpha) const
+{
+	const float WrappedDistance = WrapDistance(Distance);
+
+	// Last sample at or before the distance.
+	OutIndex = FMath::Clamp(Algo::UpperBound(Distances, WrappedDistance) - 1, 0, Locations.Num() - 2);
+
+	const float SegmentLength = Distances[OutIndex + 1] - Distances[OutIndex];
+	OutAlpha = SegmentLength > KINDA_SMALL_NUMBER ? FMath::Clamp((WrappedDistance - Distances[OutIndex]) / SegmentLength, 0.0f, 1.0f) : 0.0f;
+}
+
+FVector FDashSplineArcTable::GetLocationAtDistance(float Distance) const
+{
+	int32 Index;
+	float Alpha;
+	GetSegment(Distance, Index, Alpha);
+
+	return GetTransform().TransformPosition(FMath::Lerp(Locations[Index], Locations[Index + 1], Alpha));
+}
+
+FVector FDashSplineArcTable::GetDirectionAtDistance(float Distance) const
+{
+	int32 Index;
+	float Alpha;
+	GetSegment(Distance, Index, Alpha);
+
+	return Spline->GetComponentQuat().RotateVector(FMath::Lerp(Directions[Index], Directions[Index + 1], Alpha)).GetSafeNormal();
+}
+
+FVector FDashSplineArcTable::GetUpVectorAtDistance(float Distance) const
+{
+	int32 Index;
+	float Alpha;
+	GetSegment(Distance, Index, Alpha);
+
+	return Spline->GetComponentQuat().RotateVector(FMath::Lerp(UpVectors[Index], UpVectors[Index + 1], Alpha)).GetSafeNormal();
+}
+
+FVector FDashSplineArcTable::GetRightVectorAtDistance(float Distance) const
+{
+	return (GetUpVectorAtDistance(Distance) ^ GetDirectionAtDistance(Distance)).GetSafeNormal();
+}
+
+float FDashSplineArcTable::GetClosestDistanceOnSegment(int32 Index, const FVector& LocalLocation, float& OutDistanceSquared) const
+{
+	const FVector ClosestPoint = FMath::ClosestPointOnSegment(LocalLocation, Locations[Index], Locations[Index + 1]);
+	const float SegmentSize = FVector::Dist(Locations[Index], Locations[Index + 1]);
+	const float Alpha = SegmentSize > KINDA_SMALL_NUMBER ? FVector::Dist(Locations[Index], ClosestPoint) / SegmentSize : 0.0f;
+
+	OutDistanceSquared = FVector::DistSquared(LocalLocation, ClosestPoint);
+	return FMath::Lerp(Distances[Index], Distances[Index + 1], Alpha);
+}
+
+float FDashSplineArcTable::FindDistanceClosestToWorldLocation(const FVector& WorldLocation, float HintDistance, float SearchDistance) const
+{
+	const FVector LocalLocation = GetTransform().InverseTransformPosition(WorldLocation);
+	const int32 NumSegments = Locations.Num() - 1;
+
+	// Search the whole spline without hint, or a window around the hint.
+	int32 FirstSegment = 0;
+	int32 LastSegment = NumSegments - 1;
+	if (HintDistance >= 0.0f)
+	{
+		int32 HintSegment;
+		float HintAlpha;
+		GetSegment(HintDistance, HintSegment, HintAlpha);
+
+		const int32 SearchSegments = FMath::CeilToInt(FMath::Max(SearchDistance, 0.0f) / MinSampleDistance) + 1;
+
+		FirstSegment = HintSegment - SearchSegments;
+		LastSegment = HintSegment + SearchSegments;
+
+		if (!bClosedLoop || LastSegment - FirstSegment + 1 >= NumSegments)
+		{
+			FirstSegment = FMath::Max(FirstSegment, 0);
+			LastSegment = FMath::Min(LastSegment, NumSegments - 1);
+		}
+	}
+
+	float BestDistance = 0.0f;
+	float BestDistanceSquared = BIG_NUMBER;
+	for (int32 Segment = FirstSegment; Segment <= LastSegment; ++Segment)
+	{
+		// Window may wrap around the start of closed loops.
+		const int32 Index = (Segment % NumSegments + NumSegments) % NumSegments;
+
+		float DistanceSquared;
+		const float Distance = GetClosestDistanceOnSegment(Index, LocalLocation, DistanceSquared);
+		if (DistanceSquared < BestDistanceSquared)
+		{
+			BestDistanceSquared = DistanceSquared;
+			BestDistance = Distance;
+		}
+	}
+
+	return FMath::Min(BestDistance, Length);
+}
@@ -0,0 +1,243 @@
+////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2019 GalaxySoftware Studio
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#include "DashTickManager.h"
+#include "DashEngine.h"
+
+#include "DashActorComponent.h"
+#include "DashMovementManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Dash Batched Tick"), STAT_DashBatchedTick, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash Batched Ticks"), STAT_DashBatchedTicks, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash Batched Ticks Skipped"), STAT_DashBatchedTicksSkipped, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash Tick Dispatches Saved"), STAT_DashTickDispatchesSaved, STATGROUP_Character);
+
+
+void FDashTickManagerTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Manager != nullptr && TickType != LEVELTICK_ViewportsOnly && TickType != LEVELTICK_PauseTick)
+	{
+		Manager->Tick(DeltaTime, TickType);
+	}
+}
+
+FString FDashTickManagerTickFunction::DiagnosticMessage()
+{
+	return TEXT("FDashTickManagerTickFunction");
+}
+
+void UDashTickManager::Deinitialize()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		TickFunction.UnRegisterTickFunction();
+	}
+
+	Batches.Reset();
+	NumComponents = 0;
+
+	Super::Deinitialize();
+}
+
+bool UDashTickManager::RegisterComponent(UDashActorComponent* Component)
+{
+	if (Component == nullptr)
+	{
+		return false;
+	}
+
+	// Register the tick function with the first component.
+	if (!TickFunction.IsTickFunctionRegistered())
+	{
+		UWorld* World = GetWorld();
+		if (World == nullptr || World->PersistentLevel == nullptr)
+		{
+			return false;
+		}
+
+		TickFunction.Manager = this;
+		TickFunction.TickGroup = TG_DuringPhysics;
+		TickFunction.bCanEverTick = true;
+		TickFunction.bStartWithTickEnabled = true;
+		TickFunction.bTickEvenWhenPaused = false;
+		TickFunction.RegisterTickFunction(World->PersistentLevel);
+	}
+
+	UClass* Class = Component->GetClass();
+	FDashTickBatch* Batch = Batches.FindByPredicate([Class](const FDashTickBatch& Other)
+	{
+		return Other.Class == Class;
+	});
+
+	if (Batch == nullptr)
+	{
+		const UDashActorComponent* Defaults = GetDefault<UDashActorComponent>(Class);
+
+		Batch = &Batches.AddDefaulted_GetRef();
+		Batch->Class = Class;
+		Batch->TickInterval = Defaults->BatchedTickInterval;
+		Batch->SleepDistanceSquared = FMath::Square(Defaults->SleepDistance);
+	}
+
+	if (!Batch->Components.Contains(Component))
+	{
+		Batch->Components.Add(Component);
+		Batch->ComponentTickIntervals.Add(0.0f);
+		Batch->ComponentTimesSinceTick.Add(0.0f);
+		NumComponents++;
+	}
+
+	return true;
+}
+
+void UDashTickManager::UnregisterComponent(UDashActorComponent* Component)
+{
+	if (Component == nullptr)
+	{
+		return;
+	}
+
+	UClass* Class = Component->GetClass();
+	FDashTickBatch* Batch = Batches.FindByPredicate([Class](const FDashTickBatch& Other)
+	{
+		return Other.Class == Class;
+	});
+
+	const int32 Index = Batch != nullptr ? Batch->Components.Find(Component) : INDEX_NONE;
+	if (Index != INDEX_NONE)
+	{
+		Batch->Components.RemoveAtSwap(Index, 1, false);
+		Batch->ComponentTickIntervals.RemoveAtSwap(Index, 1, false);
+		Batch->ComponentTimesSinceTick.RemoveAtSwap(Index, 1, false);
+		NumComponents--;
+	}
+}
+
+void UDashTickManager::SetComponentTickInterval(UDashActorComponent* Component, float TickInterval)
+{
+	if (Component == nullptr)
+	{
+		return;
+	}
+
+	UClass* Class = Component->GetClass();
+	FDashTickBatch* Batch = Batches.FindByPredicate([Class](const FDashTickBatch& Other)
+	{
+		return Other.Class == Class;
+	});
+
+	const int32 Index = Batch != nullptr ? Batch->Components.Find(Component) : INDEX_NONE;
+	if (Index != INDEX_NONE)
+	{
+		Batch->ComponentTickIntervals[Index] = FMath::Max(TickInterval, 0.0f);
+	}
+}
+
+void UDashTickManager::Tick(float DeltaTime, ELevelTick TickType)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DashBatchedTick);
+
+	// Every batched component would have dispatched its own tick function.
+	INC_DWORD_STAT_BY(STAT_DashTickDispatchesSaved, FMath::Max(NumComponents - 1, 0));
+
+	CharacterLocations.Reset();
+	if (UDashMovementManager* MovementManager = GetWorld()->GetSubsystem<UDashMovementManager>())
+	{
+		MovementManager->GetCharacterLocations(CharacterLocations);
+	}
+
+	int32 NumTicks = 0;
+	int32 NumSkipped = 0;
+
+	// Components may register or unregister while ticking; index the arrays instead of holding references into them.
+	for (int32 BatchIndex = 0; BatchIndex < Batches.Num(); ++BatchIndex)
+	{
+		FDashTickBatch& Batch = Batches[BatchIndex];
+		Batch.TimeSinceTick += DeltaTime;
+		if (Batch.TimeSinceTick < Batch.TickInterval)
+		{
+			NumSkipped += Batch.Components.Num();
+			continue;
+		}
+
+		// The remainder carries over to the next tick, so it isn't part of this one.
+		const float Remainder = Batch.TickInterval > 0.0f ? FMath::Fmod(Batch.TimeSinceTick, Batch.TickInterval) : 0.0f;
+		const float BatchDeltaTime = Batch.TimeSinceTick - Remainder;
+		const float SleepDistanceSquared = Batch.SleepDistanceSquared;
+		Batch.TimeSinceTick = Remainder;
+
+		for (int32 Index = 0; Index < Batches[BatchIndex].Components.Num(); ++Index)
+		{
+			UDashActorComponent* Component = Batches[BatchIndex].Components[Index];
+			if (Component == nullptr || Component->IsPendingKill() || !Component->IsRegistered() || Component->IsBatchedTickPaused())
+			{
+				continue;
+			}
+
+			// Sleep while every Dash character is far.
+			if (SleepDistanceSquared > 0.0f && CharacterLocations.Num() > 0)
+			{
+				const AActor* Owner = Component->GetOwner();
+				const FVector Location = Owner != nullptr ? Owner->GetActorLocation() : FVector::ZeroVector;
+
+				bool bNearby = false;
+				for (const FVector& CharacterLocation : CharacterLocations)
+				{
+					if (FVector::DistSquared(Location, CharacterLocation) <= SleepDistanceSquared)
+					{
+						bNearby = true;
+						break;
+					}
+				}
+
+				if (!bNearby)
+				{
+					NumSkipped++;
+					continue;
+				}
+			}
+
+			// Components with their own interval tick with the time gathered over the batch ticks they skipped.
+			float ComponentDeltaTime = BatchDeltaTime;
+			if (Batches[BatchIndex].ComponentTickIntervals[Index] > 0.0f)
+			{
+				float& TimeSinceTick = Batches[BatchIndex].ComponentTimesSinceTick[Index];
+				TimeSinceTick += BatchDeltaTime;
+				if (TimeSinceTick < Batches[BatchIndex].ComponentTickIntervals[Index])
+				{
+					NumSkipped++;
+					continue;
+				}
+
+				ComponentDeltaTime = TimeSinceTick;
+				TimeSinceTick = 0.0f;
+			}
+
+			Component->TickComponent(ComponentDeltaTime, TickType, &Component->PrimaryComponentTick);
+			NumTicks++;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_DashBatchedTicks, NumTicks);
+	INC_DWORD_STAT_BY(STAT_DashBatchedTicksSkipped, NumSkipped);
+}
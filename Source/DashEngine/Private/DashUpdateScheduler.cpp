@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2019 GalaxySoftware Studio
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#include "DashUpdateScheduler.h"
+#include "DashEngine.h"
+
+#include "DashMovementManager.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Dash Scheduled Updates"), STAT_DashScheduledUpdates, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash Scheduled Updates Run"), STAT_DashScheduledUpdatesRun, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dash Scheduled Updates Deferred"), STAT_DashScheduledUpdatesDeferred, STATGROUP_Character);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Dash Scheduler Budget Overrun (ms)"), STAT_DashSchedulerBudgetOverrun, STATGROUP_Character);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Dash Scheduler Average Staleness (s)"), STAT_DashSchedulerAverageStaleness, STATGROUP_Character);
+
+// CVars.
+namespace DashUpdateSchedulerCVars
+{
+	static float BudgetMs = 1.0f;
+	FAutoConsoleVariableRef CVarBudgetMs(
+		TEXT("p.DashSchedulerBudgetMs"),
+		BudgetMs,
+		TEXT("Time per frame, in milliseconds, scheduled updates may take before the rest is deferred to later frames."),
+		ECVF_Default);
+
+	static float PriorityDistance = 2000.0f;
+	FAutoConsoleVariableRef CVarPriorityDistance(
+		TEXT("p.DashSchedulerPriorityDistance"),
+		PriorityDistance,
+		TEXT("Distance to the nearest Dash character at which the priority of a scheduled update is halved."),
+		ECVF_Default);
+}
+
+
+void UDashUpdateScheduler::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	NextHandle = 1;
+	AverageStaleness = 0.0f;
+}
+
+void UDashUpdateScheduler::Deinitialize()
+{
+	Items.Empty();
+	DueItems.Empty();
+
+	Super::Deinitialize();
+}
+
+int32 UDashUpdateScheduler::RegisterUpdate(AActor* Owner, const FDashScheduledUpdate& Update, float MinInterval, float MaxStaleness)
+{
+	if (!Update.IsBound())
+	{
+		return INDEX_NONE;
+	}
+
+	FDashScheduledItem& Item = Items.AddDefaulted_GetRef();
+	Item.Handle = NextHandle++;
+	Item.Owner = Owner;
+	Item.Update = Update;
+	Item.MinInterval = FMath::Max(MinInterval, 0.0f);
+	Item.MaxStaleness = FMath::Max(MaxStaleness, Item.MinInterval);
+	Item.LastUpdateTime = GetWorld()->GetTimeSeconds();
+
+	return Item.Handle;
+}
+
+void UDashUpdateScheduler::UnregisterUpdate(int32 Handle)
+{
+	// Updates may unregister while the scheduler runs them; only unbind here, removal happens on the next tick.
+	for (FDashScheduledItem& Item : Items)
+	{
+		if (Item.Handle == Handle)
+		{
+			Item.Update.Unbind();
+			break;
+		}
+	}
+}
+
+float UDashUpdateScheduler::GetAverageStaleness() const
+{
+	return AverageStaleness;
+}
+
+void UDashUpdateScheduler::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DashScheduledUpdates);
+
+	UWorld* World = GetWorld();
+	const float Time = World->GetTimeSeconds();
+
+	// Remove unregistered updates and updates of destroyed actors.
+	for (int32 Index = Items.Num() - 1; Index >= 0; --Index)
+	{
+		const FDashScheduledItem& Item = Items[Index];
+		if (!Item.Update.IsBound() || (!Item.Owner.IsValid() && !Item.Owner.IsExplicitlyNull()))
+		{
+			Items.RemoveAtSwap(Index, 1, false);
+		}
+	}
+
+	CharacterLocations.Reset();
+	if (UDashMovementManager* MovementManager = World->GetSubsystem<UDashMovementManager>())
+	{
+		MovementManager->GetCharacterLocations(CharacterLocations);
+	}
+
+	// Priority grows with the time since the last update and shrinks with the distance to the nearest character.
+	const float InvPriorityDistance = 1.0f / FMath::Max(DashUpdateSchedulerCVars::PriorityDistance, 1.0f);
+
+	DueItems.Reset();
+	for (int32 Index = 0; Index < Items.Num(); ++Index)
+	{
+		const FDashScheduledItem& Item = Items[Index];
+		const float Staleness = Time - Item.LastUpdateTime;
+		if (Staleness < Item.MinInterval)
+		{
+			continue;
+		}
+
+		float Distance = 0.0f;
+		if (const AActor* Owner = Item.Owner.Get())
+		{
+			const FVector Location = Owner->GetActorLocation();
+
+			float DistanceSquared = CharacterLocations.Num() > 0 ? BIG_NUMBER : 0.0f;
+			for (const FVector& CharacterLocation : CharacterLocations)
+			{
+				DistanceSquared = FMath::Min(DistanceSquared, FVector::DistSquared(Location, CharacterLocation));
+			}
+
+			Distance = FMath::Sqrt(DistanceSquared);
+		}
+
+		DueItems.Emplace(Staleness / (1.0f + Distance * InvPriorityDistance), Index);
+	}
+
+	DueItems.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B)
+	{
+		return A.Key > B.Key;
+	});
+
+	// Run by priority within the budget; starved updates run regardless.
+	const double StartTime = FPlatformTime::Seconds();
+	const double Budget = DashUpdateSchedulerCVars::BudgetMs * 0.001;
+	bool bOverBudget = false;
+	int32 NumRun = 0;
+	int32 NumDeferred = 0;
+
+	for (const TPair<float, int32>& DueItem : DueItems)
+	{
+		const int32 Index = DueItem.Value;
+		const float Staleness = Time - Items[Index].LastUpdateTime;
+
+		bOverBudget = bOverBudget || FPlatformTime::Seconds() - StartTime >= Budget;
+		if (bOverBudget && Staleness < Items[Index].MaxStaleness)
+		{
+			NumDeferred++;
+			continue;
+		}
+
+		// Copy the delegate; the update may register others and grow the array.
+		Items[Index].LastUpdateTime = Time;
+		FDashScheduledUpdate Update = Items[Index].Update;
+		Update.ExecuteIfBound(Staleness);
+		NumRun++;
+	}
+
+	const double Overrun = FMath::Max(FPlatformTime::Seconds() - StartTime - Budget, 0.0);
+
+	float TotalStaleness = 0.0f;
+	for (const FDashScheduledItem& Item : Items)
+	{
+		TotalStaleness += Time - Item.LastUpdateTime;
+	}
+
+	AverageStaleness = Items.Num() > 0 ? TotalStaleness / Items.Num() : 0.0f;
+
+	INC_DWORD_STAT_BY(STAT_DashScheduledUpdatesRun, NumRun);
+	INC_DWORD_STAT_BY(STAT_DashScheduledUpdatesDeferred, NumDeferred);
+	SET_FLOAT_STAT(STAT_DashSchedulerBudgetOverrun, float(Overrun * 1000.0));
+	SET_FLOAT_STAT(STAT_DashSchedulerAverageStaleness, AverageStaleness);
+}
+
+bool UDashUpdateScheduler::IsTickable() const
+{
+	return Items.Num() > 0 && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+UWorld* UDashUpdateScheduler::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UDashUpdateScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDashUpdateScheduler, STATGROUP_Tickables);
+}
@@ -21,11 +21,27 @@ protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+	// Called when the game ends or the component is destroyed
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:	
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	virtual void PostInitProperties() override;
 
+	/** Pauses or resumes the batched tick instead of the own tick function of a batched component. */
+	virtual void SetComponentTickEnabled(bool bEnabled) override;
+
+	/**
+	* Return whether the batched tick of the component is paused by SetComponentTickEnabled.
+	*/
+	FORCEINLINE bool IsBatchedTickPaused() const { return bIsTickBatchPaused; }
+
+	/**
+	* Return whether the component is ticked by the Dash tick manager instead of by its own tick function.
+	*/
+	FORCEINLINE bool IsTickBatched() const { return bIsTickBatched; }
+
 public:
 	// Reproduction of construction script
 	UFUNCTION(BlueprintNativeEvent)
@@ -34,4 +50,27 @@ public:
 	UFUNCTION(BlueprintNativeEvent)
 	void OnConstructed_InGame();
 
+public:
+	/**
+	* If true and the component ticks, it's ticked by the Dash tick manager with the other components of its class instead of by its own tick function.
+	* Components that tick in another group than During Physics, tick even when paused, or have tick prerequisites when they begin play keep their own tick function.
+	*/
+	UPROPERTY(Category = "ComponentTick", EditDefaultsOnly, BlueprintReadOnly)
+		uint32 bUseBatchedTick : 1;
+
+	/** Time between two batched ticks, shared by the class; zero to tick every frame. */
+	UPROPERTY(Category = "ComponentTick", EditDefaultsOnly, BlueprintReadOnly, meta = (ClampMin = "0", UIMin = "0", EditCondition = "bUseBatchedTick"))
+		float BatchedTickInterval;
+
+	/** Batched ticks are skipped while every Dash character is farther than this from the owner; zero to always tick. */
+	UPROPERTY(Category = "ComponentTick", EditDefaultsOnly, BlueprintReadOnly, meta = (ClampMin = "0", UIMin = "0", EditCondition = "bUseBatchedTick"))
+		float SleepDistance;
+
+protected:
+	/** Whether the component is ticked by the Dash tick manager. */
+	uint32 bIsTickBatched : 1;
+
+	/** Whether the tick manager skips the component, after its tick was disabled while batched. */
+	uint32 bIsTickBatchPaused : 1;
+
 };
\ No newline at end of file
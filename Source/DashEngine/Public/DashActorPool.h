@@ -0,0 +1,171 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Tickable.h"
+#include "UObject/Interface.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DashActorPool.generated.h"
+
+class APawn;
+
+
+UINTERFACE(BlueprintType)
+class DASHENGINE_API UDashPooledActor : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+* Reset hooks of actors spawned through the actor pool. BeginPlay only runs the first time a pooled actor is spawned;
+* state changed during play (e.g. a broken monitor) must be restored in OnAcquiredFromPool.
+*/
+class DASHENGINE_API IDashPooledActor
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	* Called when the actor is taken from the pool, after it's moved to its spawn transform and shown.
+	*/
+	UFUNCTION(Category = "Actor Pool", BlueprintNativeEvent)
+		void OnAcquiredFromPool();
+
+	/**
+	* Called when the actor is released to the pool, before it's hidden.
+	*/
+	UFUNCTION(Category = "Actor Pool", BlueprintNativeEvent)
+		void OnReleasedToPool();
+};
+
+
+/**
+* Actors of a class kept by the actor pool.
+*/
+USTRUCT()
+struct FDashActorPoolClass
+{
+	GENERATED_BODY()
+
+	/** Released actors, ready to be spawned again. */
+	UPROPERTY(Transient)
+		TArray<AActor*> FreeActors;
+
+	/** Amount of actors spawned from the pool and not released yet. */
+	int32 NumActive;
+
+	/** Largest amount of actors of the class alive at once. */
+	int32 PeakSize;
+
+	FDashActorPoolClass()
+		: NumActive(0), PeakSize(0)
+	{
+	}
+};
+
+
+/**
+* Pool of actors spawned and destroyed over and over during play (monitors, balloons, projectiles, shields...).
+* Released actors are hidden and disabled instead of destroyed, and spawned again without registering their components.
+* Classes listed in the Dash Engine project settings are spawned when a game world starts.
+* @note Warm-ups wait for the world to begin play, so the BeginPlay of warmed actors runs before they're disabled.
+*/
+UCLASS()
+class DASHENGINE_API UDashActorPoolSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Warm up the pool once the actors of the world are initialized. */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Forget the pooled actors; they are destroyed with the world. */
+	virtual void Deinitialize() override;
+
+public:
+	/**
+	* Spawn an actor, reusing a released actor of its class if possible.
+	*
+	* @param ActorClass - Class of the actor.
+	* @param Transform - Transform of the actor.
+	* @param Owner - Owner of the actor.
+	* @param Instigator - Pawn responsible for the damage caused by the actor.
+	* @return Spawned actor; null if spawning failed.
+	*/
+	UFUNCTION(Category = "Actor Pool", BlueprintCallable, meta = (DeterminesOutputType = "ActorClass"))
+		AActor* SpawnPooledActor(TSubclassOf<AActor> ActorClass, const FTransform& Transform, AActor* Owner = nullptr, APawn* Instigator = nullptr);
+
+	/**
+	* Release an actor to the pool instead of destroying it; destroys it if the pool of its class is full.
+	*
+	* @param Actor - Actor to release.
+	*/
+	UFUNCTION(Category = "Actor Pool", BlueprintCallable)
+		void ReleasePooledActor(AActor* Actor);
+
+	/**
+	* Spawn actors of a class in the pool until it holds at least a given amount of released actors;
+	* before the world begins play, the actors are spawned once it has.
+	*
+	* @param ActorClass - Class of the actors.
+	* @param Count - Amount of released actors to reach.
+	*/
+	UFUNCTION(Category = "Actor Pool", BlueprintCallable)
+		void WarmUp(TSubclassOf<AActor> ActorClass, int32 Count);
+
+	/**
+	* Return the amount of released actors of a class kept by the pool.
+	*/
+	UFUNCTION(Category = "Actor Pool", BlueprintPure)
+		int32 GetNumFreeActors(TSubclassOf<AActor> ActorClass) const;
+
+public:
+	/** Run the pending warm-ups once the world has begun play. */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Ticks while warm-ups are pending. */
+	virtual bool IsTickable() const override;
+
+	/** Ticks with the world of the subsystem. */
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+	/** Stat ID of the tick. */
+	virtual TStatId GetStatId() const override;
+
+protected:
+	/**
+	* Warm up the classes of the project settings.
+	*/
+	void OnActorsInitialized(const UWorld::FActorsInitializedParams& Params);
+
+	/**
+	* Hide and disable an actor kept by the pool.
+	*/
+	void DeactivateActor(AActor* Actor);
+
+	/**
+	* Show and enable an actor taken from the pool, restarting its initial life span.
+	*/
+	void ActivateActor(AActor* Actor, const FTransform& Transform, AActor* Owner, APawn* Instigator);
+
+	/**
+	* Record that an actor of a class was spawned, for the peak size.
+	*/
+	void AddActive(FDashActorPoolClass& Pool);
+
+protected:
+	/** Pool of each class. */
+	UPROPERTY(Transient)
+		TMap<UClass*, FDashActorPoolClass> Pools;
+
+	/** Amount of released actors to reach for each class once the world has begun play. */
+	UPROPERTY(Transient)
+		TMap<UClass*, int32> PendingWarmUps;
+
+	/** Maximum amount of released actors per class. */
+	int32 MaxFreeActors;
+
+	/** Handle of the actors initialized delegate. */
+	FDelegateHandle ActorsInitializedHandle;
+};
@@ -0,0 +1,25 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "DashBakeCollisionSDFCommandlet.generated.h"
+
+
+/**
+* Bakes the static collision of maps into UDashCollisionSDF assets saved beside them, as <Map>_CollisionSDF.
+*
+* Usage: UE4Editor-Cmd DashEngine.uproject -run=DashBakeCollisionSDF -Map=TestMap+2DTestMap [-VoxelSize=20] [-BrickSize=8] [-Channel=Pawn]
+*/
+UCLASS()
+class DASHENGINE_API UDashBakeCollisionSDFCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UDashBakeCollisionSDFCommandlet();
+
+public:
+	/** Bake every map of the command line. */
+	virtual int32 Main(const FString& Params) override;
+};
@@ -8,8 +8,246 @@
 
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/NavMovementComponent.h"
+#include "WorldCollision.h"
+#include "DashSplineArcTable.h"
 #include "DashCharacterMovementComponent.generated.h"
 
+class USplineComponent;
+class UDashCollisionSDFSubsystem;
+class UDashGravityFieldSubsystem;
+class UDashRingSubsystem;
+class UDashSignificanceManager;
+
+
+/**
+* Gravity state replicated from server to clients; members are quantized and delta replicated individually.
+*/
+USTRUCT()
+struct FDashReplicatedGravity
+{
+	GENERATED_BODY()
+
+	/** Custom gravity direction; zero if there's no custom direction. */
+	UPROPERTY()
+		FVector_NetQuantizeNormal Direction;
+
+	/** Gravity point; zero if disabled. */
+	UPROPERTY()
+		FVector_NetQuantize10 Point;
+
+	/** Gravity scale. */
+	UPROPERTY()
+		float Scale;
+
+	FDashReplicatedGravity()
+		: Direction(FVector::ZeroVector), Point(FVector::ZeroVector), Scale(1.0f)
+	{
+	}
+};
+
+
+/**
+* Shape of the path followed by a character, replicated from server to simulated proxies so they can extrapolate along curves.
+*/
+USTRUCT()
+struct FDashReplicatedPath
+{
+	GENERATED_BODY()
+
+	/** Angular velocity of the velocity direction, in radians per second; zero while falling. */
+	UPROPERTY()
+		FVector_NetQuantize100 AngularVelocity;
+
+	/** Normal of the walked floor; zero if not walking. */
+	UPROPERTY()
+		FVector_NetQuantizeNormal FloorNormal;
+
+	FDashReplicatedPath()
+		: AngularVelocity(FVector::ZeroVector), FloorNormal(FVector::ZeroVector)
+	{
+	}
+};
+
+
+/**
+* Custom movement modes of Dash characters, stored in CustomMovementMode when MovementMode is MOVE_Custom.
+*/
+UENUM(BlueprintType)
+enum EDashCustomMovementMode
+{
+	/** None (custom movement is disabled). */
+	CMOVE_None			UMETA(DisplayName = "None"),
+
+	/** Movement along a spline, e.g. a grinding rail. */
+	CMOVE_Grinding		UMETA(DisplayName = "Grinding"),
+
+	CMOVE_MAX			UMETA(Hidden),
+};
+
+
+/**
+* Call sites of the collision queries issued by Dash character movement.
+*/
+UENUM(BlueprintType)
+enum class EDashCollisionQuery : uint8
+{
+	/** Downward capsule (or box) sweeps of floor checks. */
+	FloorSweep,
+
+	/** Line trace of floor checks, done when the sweep is stuck in penetration. */
+	FloorLineTrace,
+
+	/** Sweeping moves done while stepping up. */
+	StepUp,
+
+	/** Other sweeping moves of the updated component. */
+	Move,
+
+	/** Sweeps testing for ledges. */
+	CheckLedgeDirection,
+
+	/** Traces testing for a wall to jump out of water. */
+	CheckWaterJump,
+
+	/** Trace against the water volume. */
+	ImmersionDepth,
+
+	/** Traces against overlapped physics bodies. */
+	RepulsionForce,
+
+	/** Overlap tests and sweeps of crouching and uncrouching. */
+	Crouch,
+
+	/** Asynchronous floor sweep for the next tick. */
+	AsyncFloorProbe,
+
+	/** Trace looking for walls while grinding. */
+	GrindProbe,
+
+	/** Sphere traces against the baked collision distance field of the map. */
+	CollisionSDF,
+
+	MAX UMETA(Hidden)
+};
+
+
+/**
+* Movement detail levels of simulated proxies.
+*/
+UENUM(BlueprintType)
+enum class EDashSimulatedMovementLOD : uint8
+{
+	/** Full simulation with sweeps and floor checks. */
+	Full,
+
+	/** Moves along the replicated velocity without collision or floor checks. */
+	Extrapolate,
+
+	/** Interpolates between replicated snapshots, slightly in the past. */
+	Interpolate
+};
+
+
+/**
+* Replicated location and rotation of a simulated proxy, along with the time it was received.
+*/
+struct FDashSimulatedSnapshot
+{
+	/** World time when the snapshot was received. */
+	float Time;
+
+	/** Replicated location. */
+	FVector Location;
+
+	/** Replicated rotation. */
+	FQuat Rotation;
+
+	/** Replicated velocity. */
+	FVector Velocity;
+};
+
+
+/**
+* Gravity and component axes of the current substep, queried dozens of times per tick by the movement code.
+* Values are computed on first use and kept while the inputs they were computed from don't change.
+*/
+struct FDashFrameState
+{
+	/** Component rotation the axes were computed from. */
+	FQuat AxesRotation;
+
+	/** X and Z axes of the component. */
+	FVector AxisX;
+	FVector AxisZ;
+
+	/** Component location and gravity settings the gravity was computed from. */
+	FVector GravityLocation;
+	FVector GravityCustomDirection;
+	FVector GravityPoint;
+	float GravityScale;
+
+	/** Gravity, its direction, and its direction avoiding zero gravity. */
+	FVector Gravity;
+	FVector GravityDirection;
+	FVector SafeGravityDirection;
+
+	/** Which values are valid. */
+	uint32 bAxesValid : 1;
+	uint32 bGravityKeyValid : 1;
+	uint32 bGravityValid : 1;
+	uint32 bGravityDirectionValid : 1;
+	uint32 bSafeGravityDirectionValid : 1;
+
+	FDashFrameState()
+	{
+		Invalidate();
+	}
+
+	/** Discard every value. */
+	FORCEINLINE void Invalidate()
+	{
+		bAxesValid = false;
+		bGravityKeyValid = false;
+		bGravityValid = false;
+		bGravityDirectionValid = false;
+		bSafeGravityDirectionValid = false;
+	}
+};
+
+
+/**
+* Walkable floor found by a downward capsule sweep, along with the query that found it.
+*/
+struct FDashFloorCache
+{
+	/** Floor result of the cached query. */
+	FFindFloorResult FloorResult;
+
+	/** Transform of the floor component when the query was done. */
+	FTransform FloorTransform;
+
+	/** Capsule location used for the query. */
+	FVector CapsuleLocation;
+
+	/** Capsule 'up' axis used for the query. */
+	FVector CapsuleUp;
+
+	/** Query and capsule dimensions. */
+	float SweepDistance;
+	float SweepRadius;
+	float CapsuleRadius;
+	float CapsuleHalfHeight;
+
+	/** If true, the cached data can be reused. */
+	bool bValid;
+
+	FDashFloorCache()
+		: FloorTransform(FTransform::Identity), CapsuleLocation(FVector::ZeroVector), CapsuleUp(FVector::UpVector), SweepDistance(0.0f),
+		 SweepRadius(0.0f), CapsuleRadius(0.0f), CapsuleHalfHeight(0.0f), bValid(false)
+	{
+	}
+};
+
 
 /**
 * Component that handles arbitrary gravity direction and collision capsule
@@ -20,6 +258,8 @@ class DASHENGINE_API UDashCharacterMovementComponent : public UCharacterMovement
 {
 	GENERATED_BODY()
 
+	friend class FSavedMove_DashCharacter;
+
 public:
 	/**
 	* Default UObject constructor.
@@ -380,6 +620,20 @@ public:
 	/** Perform rotation over deltaTime */
 	virtual void PhysicsRotation(float DeltaTime) override;
 
+protected:
+	/**
+	* Return the rotation facing the acceleration, or the requested velocity of path following.
+	*
+	* @param CurrentQuat - Current rotation, returned when there's no acceleration.
+	* @return Desired rotation, before constraints.
+	*/
+	virtual FQuat ComputeOrientToMovementQuat(const FQuat& CurrentQuat) const;
+
+public:
+	/** Forwards to ComputeOrientToMovementQuat; PhysicsRotation no longer calls it. */
+	UE_DEPRECATED(4.25, "PhysicsRotation no longer calls ComputeOrientToMovementRotation; override ComputeOrientToMovementQuat instead.")
+	virtual FRotator ComputeOrientToMovementRotation(const FRotator& CurrentRotation, float DeltaTime, FRotator& DeltaRotation) const override;
+
 public:
 	/** Delegate when PhysicsVolume of UpdatedComponent has been changed **/
 	virtual void PhysicsVolumeChanged(class APhysicsVolume* NewVolume) override;
@@ -589,13 +843,6 @@ protected:
 	UPROPERTY(Category = "Dash Character Movement", VisibleAnywhere)
 		FVector CustomGravityDirection;
 
-protected:
-	/**
-	* If true, CustomGravityDirection changed and needs to be replicated.
-	* @see CustomGravityDirection
-	*/
-	uint32 bDirtyCustomGravityDirection : 1;
-
 protected:
 	/**
 	* If true, gravity data isn't replicated from server to clients.
@@ -611,6 +858,40 @@ public:
 	*/
 	virtual FVector GetGravity() const;
 
+protected:
+	/**
+	* Compute the current gravity, bypassing the frame state.
+	*
+	* @return Current gravity.
+	*/
+	FVector ComputeGravity() const;
+
+protected:
+	/**
+	* Compute the normalized direction of the current gravity, bypassing the frame state.
+	*
+	* @param bAvoidZeroGravity - If true, zero gravity isn't returned.
+	* @return Normalized direction of current gravity.
+	*/
+	FVector ComputeGravityDirection(bool bAvoidZeroGravity) const;
+
+protected:
+	/**
+	* Return the gravity of this component alone, from its custom gravity direction, gravity point or the world gravity.
+	*
+	* @return Gravity ignoring gravity volumes.
+	*/
+	FVector GetComponentGravity() const;
+
+protected:
+	/**
+	* Return the gravity of the gravity volumes at the location of the component.
+	*
+	* @param OutGravity - Blended gravity of the volumes, scaled by GravityScale.
+	* @return Influence of the volumes, in [0, 1]; the component gravity fills the rest.
+	*/
+	float GetFieldGravity(FVector& OutGravity) const;
+
 public:
 	/**
 	* Return the normalized direction of the current gravity.
@@ -650,21 +931,6 @@ protected:
 	*/
 	FORCEINLINE void SetCustomGravityDirection(const FVector& NewCustomGravityDirection);
 
-protected:
-	/**
-	* Replicate custom non-zero gravity direction to clients.
-	*
-	* @param NewCustomGravityDirection - New custom gravity direction, assumes it is normalized.
-	*/
-	UFUNCTION(Client, Reliable)
-		virtual void ClientSetCustomGravityDirection(const FVector& NewCustomGravityDirection);
-
-	/**
-	* Replicate custom zero gravity direction to clients.
-	*/
-	UFUNCTION(Client, Reliable)
-		virtual void ClientClearCustomGravityDirection();
-
 public:
 	/**
 	* Gravity direction points to this location; use 0,0,0 to disable it.
@@ -673,43 +939,56 @@ public:
 	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere)
 		FVector GravityPoint;
 
+public:
+	/**
+	* If true, gravity volumes (see ADashGravityVolume) override the custom gravity direction and gravity point inside them.
+	*/
+	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere)
+		uint32 bUseGravityField : 1;
+
 protected:
 	/**
-	* Stores last known value of GravityPoint.
-	* @see GravityPoint
+	* Gravity field of the world; null if it isn't used.
 	*/
-	FVector OldGravityPoint;
+	UPROPERTY(Transient)
+		UDashGravityFieldSubsystem* GravityField;
 
 protected:
 	/**
-	* Replicate non-zero gravity point to clients.
-	*
-	* @param NewGravityPoint - New custom gravity point.
+	* Gravity state replicated to clients.
+	* @see UpdateReplicatedGravity
 	*/
-	UFUNCTION(Client, Reliable)
-		virtual void ClientSetGravityPoint(const FVector& NewGravityPoint);
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedGravity)
+		FDashReplicatedGravity ReplicatedGravity;
 
 	/**
-	* Replicate zero gravity point to clients.
+	* Apply replicated gravity state on clients.
 	*/
-	UFUNCTION(Client, Reliable)
-		virtual void ClientClearGravityPoint();
+	UFUNCTION()
+		virtual void OnRep_ReplicatedGravity();
+
+public:
+	/**
+	* Minimum angle (in degrees) between the replicated and the current custom gravity directions to replicate a new direction.
+	*/
+	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0", UIMax = "15"))
+		float GravityReplicationAngleThreshold;
 
-protected:
 	/**
-	* Stores last known value of GravityScale.
-	* @see GravityScale
+	* Minimum distance between the replicated and the current gravity points to replicate a new point.
 	*/
-	float OldGravityScale;
+	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0", UIMax = "100"))
+		float GravityReplicationPointThreshold;
 
 protected:
 	/**
-	* Replicate gravity scale to clients.
-	*
-	* @param NewGravityScale - New gravity scale factor.
+	* Copy current gravity state to ReplicatedGravity on the server if it changed more than the thresholds.
 	*/
-	UFUNCTION(Client, Reliable)
-		virtual void ClientSetGravityScale(float NewGravityScale);
+	virtual void UpdateReplicatedGravity();
+
+public:
+	/** Returns the properties used for network replication. */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 public:
 	/**
@@ -727,13 +1006,23 @@ public:
 
 public:
 	/**
-	* Calculate a constrained rotation for the updated component.
+	* Calculate a constrained rotation for the updated component; forwards to ConstrainComponentQuat.
 	*
 	* @param Rotation - Initial rotation.
 	* @return New rotation to use.
 	*/
+	UE_DEPRECATED(4.25, "Rotations no longer go through ConstrainComponentRotation; override ConstrainComponentQuat instead.")
 	virtual FRotator ConstrainComponentRotation(const FRotator& Rotation) const;
 
+public:
+	/**
+	* Calculate a constrained rotation for the updated component, without Euler angles.
+	*
+	* @param Rotation - Initial rotation.
+	* @return New rotation to use.
+	*/
+	virtual FQuat ConstrainComponentQuat(const FQuat& Rotation) const;
+
 protected:
 	/**
 	* Return the current local X rotation axis of the updated component.
@@ -777,4 +1066,902 @@ public:
 	* Update the rotation of the updated component.
 	*/
 	virtual void UpdateComponentRotation();
+
+public:
+	/**
+	* If true, movement is simulated with a constant time step of 1 / FixedTimeStepRate seconds and the mesh
+	* is interpolated between the last two simulated states; results no longer depend on frame rate.
+	* @note Only applies to characters with authority that aren't driven by a remote client (standalone, listen host, AI).
+	*/
+	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere)
+		uint32 bUseFixedTimeStep : 1;
+
+	/**
+	* Frequency (in Hz) of the fixed simulation step.
+	* @see bUseFixedTimeStep
+	*/
+	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "10", UIMin = "30", UIMax = "240"))
+		float FixedTimeStepRate;
+
+	/**
+	* Maximum amount of fixed steps simulated in a single frame; time that exceeds it is dropped.
+	* Bounds the cost of a frame when the game hitches.
+	* @see bUseFixedTimeStep
+	*/
+	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "1", UIMin = "1", UIMax = "8"))
+		int32 MaxFixedTimeSteps;
+
+protected:
+	/**
+	* Simulated time that hasn't been consumed by a fixed step yet.
+	*/
+	float FixedTimeStepAccumulator;
+
+	/**
+	* Location of the updated component before the last fixed step.
+	*/
+	FVector FixedTimeStepPreviousLocation;
+
+	/**
+	* Rotation of the updated component before the last fixed step.
+	*/
+	FQuat FixedTimeStepPreviousRotation;
+
+	/**
+	* If true, fixed steps are running and the mesh is interpolated.
+	*/
+	uint32 bFixedTimeStepActive : 1;
+
+protected:
+	/** Perform movement on an autonomous client or on the server; splits DeltaTime into fixed steps if bUseFixedTimeStep is true. */
+	virtual void PerformMovement(float DeltaTime) override;
+
+protected:
+	/**
+	* Return true if movement can be simulated with fixed steps.
+	*
+	* @return True if fixed steps are allowed for the owner.
+	*/
+	virtual bool CanUseFixedTimeStep() const;
+
+protected:
+	/**
+	* Place the mesh between the last two simulated states of the updated component.
+	*
+	* @param Alpha - Interpolation factor between previous (0) and current (1) states.
+	*/
+	virtual void InterpolateFixedTimeStepMesh(float Alpha);
+
+protected:
+	/**
+	* Discard accumulated time and interpolation state, and restore the mesh to its base offset.
+	*/
+	virtual void ResetFixedTimeStep();
+
+public:
+	/**
+	* If true, ComputeFloorDist reuses the last walkable floor found by a sweep while the capsule barely moves
+	* on the same floor component, instead of sweeping again.
+	*/
+	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere)
+		uint32 bEnableFloorCache : 1;
+
+	/**
+	* Maximum distance the capsule can move away from the location of the cached floor query before a new sweep is required.
+	* @see bEnableFloorCache
+	*/
+	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0", UIMax = "10"))
+		float FloorCacheMaxMoveDistance;
+
+public:
+	/**
+	* Discard the cached floor; the next floor query will sweep.
+	*/
+	void InvalidateFloorCache();
+
+protected:
+	/**
+	* Last walkable floor found by a sweep.
+	* @see bEnableFloorCache
+	*/
+	mutable FDashFloorCache FloorCache;
+
+protected:
+	/**
+	* Try to compute the floor from a cached floor query, projecting the capsule move onto the cached floor plane.
+	*
+	* @param Cache - Cached floor query.
+	* @param MaxMoveDistance - Maximum distance between the cached and the new capsule locations.
+	* @param CapsuleLocation - Location of the capsule used for the query.
+	* @param SweepDistance - Max distance to use when sweeping a capsule downwards.
+	* @param SweepRadius - The radius to use for sweep tests.
+	* @param OutFloorResult - Result of the floor check, only modified on success.
+	* @return True if the cached floor is still valid for this query.
+	*/
+	bool ComputeCachedFloorDist(const FDashFloorCache& Cache, float MaxMoveDistance, const FVector& CapsuleLocation, float SweepDistance, float SweepRadius, FFindFloorResult& OutFloorResult) const;
+
+protected:
+	/**
+	* Store the result of a floor query that found a walkable floor with a sweep.
+	*
+	* @param Cache - Cache to fill; invalidated if the floor can't be projected.
+	* @param CapsuleLocation - Location of the capsule used for the query.
+	* @param CapsuleUp - 'Up' axis of the capsule used for the query.
+	* @param SweepDistance - Max distance to use when sweeping a capsule downwards.
+	* @param SweepRadius - The radius to use for sweep tests.
+	* @param FloorResult - Result of the floor check.
+	*/
+	void UpdateFloorCache(FDashFloorCache& Cache, const FVector& CapsuleLocation, const FVector& CapsuleUp, float SweepDistance, float SweepRadius, const FFindFloorResult& FloorResult) const;
+
+public:
+	/**
+	* If true, an asynchronous floor sweep is issued at the end of each tick at the predicted capsule location of the next frame;
+	* ComputeFloorDist uses it if the capsule ends up close enough, otherwise it sweeps synchronously.
+	* @note Ignored if bUseFlatBaseForFloorChecks is true.
+	*/
+	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere)
+		uint32 bUseAsyncFloorProbe : 1;
+
+	/**
+	* Maximum distance between the predicted and the actual capsule locations for the asynchronous floor sweep to be used.
+	* @see bUseAsyncFloorProbe
+	*/
+	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0", UIMax = "50"))
+		float AsyncFloorProbeTolerance;
+
+public:
+	/** Component tick; issues the asynchronous floor sweep for the next frame. */
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+	/**
+	* Issue an asynchronous floor sweep at the capsule location predicted for the next frame.
+	*
+	* @param DeltaTime - Time elapsed since last frame, used as the prediction interval.
+	*/
+	virtual void RequestAsyncFloorProbe(float DeltaTime);
+
+protected:
+	/**
+	* Collect the result of the asynchronous floor sweep if it's ready.
+	*
+	* @return True if a usable floor is stored in AsyncFloorProbe, from the asynchronous sweep or the movement prepass.
+	*/
+	bool CollectAsyncFloorProbe() const;
+
+protected:
+	/**
+	* Fill the query of AsyncFloorProbe for the capsule location predicted after DeltaTime.
+	*
+	* @param DeltaTime - Prediction interval.
+	* @param OutCapsuleShape - Shrunk capsule to sweep with.
+	* @param OutStart - Start location of the sweep.
+	* @param OutEnd - End location of the sweep.
+	* @return True if a floor probe can be done.
+	*/
+	bool BeginFloorProbe(float DeltaTime, FCollisionShape& OutCapsuleShape, FVector& OutStart, FVector& OutEnd) const;
+
+protected:
+	/**
+	* Validate the hit of a floor probe and store it in AsyncFloorProbe.
+	*
+	* @param Hit - First blocking hit of the sweep.
+	* @param TraceDist - Length of the sweep.
+	*/
+	void FinishFloorProbe(const FHitResult& Hit, float TraceDist) const;
+
+protected:
+	/**
+	* Handle of the pending asynchronous floor sweep.
+	*/
+	mutable FTraceHandle AsyncFloorProbeHandle;
+
+	/**
+	* Walkable floor found by the last asynchronous floor sweep.
+	*/
+	mutable FDashFloorCache AsyncFloorProbe;
+
+	/**
+	* Frame in which the pending asynchronous floor sweep was issued.
+	*/
+	uint64 AsyncFloorProbeFrame;
+
+	/**
+	* Distance the pending asynchronous floor sweep starts above the capsule bottom, because of the shrunk capsule.
+	*/
+	mutable float AsyncFloorProbeShrinkHeight;
+
+public:
+	/** Called when the game starts; registers with the movement manager. */
+	virtual void BeginPlay() override;
+
+	/** Called when the game ends; unregisters from the movement manager. */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	/**
+	* If true, the movement manager predicts the floor of the next move before the component ticks, possibly on a worker thread;
+	* ComputeFloorDist uses it if the capsule ends up within AsyncFloorProbeTolerance of the prediction.
+	* @note Ignored if bUseAsyncFloorProbe is true, which already predicts the floor.
+	*/
+	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere)
+		uint32 bUseMovementPrepass : 1;
+
+public:
+	/**
+	* Return true if the movement manager should call PrepareMovement this frame.
+	*
+	* @return True if the prepass is useful for the current state.
+	*/
+	virtual bool ShouldPrepareMovement() const;
+
+	/**
+	* Movement prepass run by the movement manager before the component ticks, possibly on a worker thread.
+	* Predicts the floor at the end of the next move; must only read shared state.
+	*
+	* @param DeltaTime - Time elapsed since last frame.
+	*/
+	virtual void PrepareMovement(float DeltaTime);
+
+public:
+	/**
+	* Maximum world arc length between two samples of the grinding and path lock spline tables.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Grinding", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "1", UIMin = "5", UIMax = "200"))
+		float GrindSampleDistance;
+
+	/**
+	* Distance between the spline and the bottom of the capsule while grinding.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Grinding", BlueprintReadWrite, EditAnywhere)
+		float GrindHeightOffset;
+
+	/**
+	* Deceleration applied along the spline while grinding.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Grinding", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float GrindBrakingDeceleration;
+
+	/**
+	* Minimum speed kept along the spline while grinding; the grinder never slows down below it, so it can't stop
+	* and slide back down an uphill rail. Zero lets gravity reverse the grinder.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Grinding", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float GrindMinSpeed;
+
+	/**
+	* If true, the capsule is rotated to match the spline frame while grinding.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Grinding", BlueprintReadWrite, EditAnywhere)
+		uint32 bAlignComponentToGrindSpline : 1;
+
+public:
+	/**
+	* Start grinding along a spline from the closest point to the character; keeps the speed along the spline.
+	* Max speed is given by MaxCustomMovementSpeed.
+	* @note The arc length table of the last spline is kept, so points of that spline changed at runtime are ignored.
+	*
+	* @param Spline - Spline to grind on.
+	* @return True if grinding started.
+	*/
+	UFUNCTION(Category = "Pawn|Components|DashCharacterMovement", BlueprintCallable)
+		virtual bool StartGrinding(USplineComponent* Spline);
+
+	/**
+	* Stop grinding and start falling.
+	*/
+	UFUNCTION(Category = "Pawn|Components|DashCharacterMovement", BlueprintCallable)
+		virtual void StopGrinding();
+
+	/**
+	* Return true if the character is grinding along a spline.
+	*
+	* @return True if the current movement mode is grinding.
+	*/
+	UFUNCTION(Category = "Pawn|Components|DashCharacterMovement", BlueprintPure)
+		bool IsGrinding() const;
+
+	/**
+	* Return the spline the character is grinding on.
+	*
+	* @return Grinding spline, or null if not grinding.
+	*/
+	UFUNCTION(Category = "Pawn|Components|DashCharacterMovement", BlueprintPure)
+		USplineComponent* GetGrindSpline() const;
+
+public:
+	/** Returns true if current movement state allows an attempt at jumping; jumping off rails is allowed. */
+	virtual bool CanAttemptJump() const override;
+
+protected:
+	/** @note Movement update functions should only be called through StartNewPhysics() */
+	virtual void PhysCustom(float deltaTime, int32 Iterations) override;
+
+protected:
+	/**
+	* Move along the grinding spline by spline distance; no floor checks are done, only a line trace probes for obstacles.
+	* @note Movement update functions should only be called through StartNewPhysics()
+	*/
+	virtual void PhysGrinding(float deltaTime, int32 Iterations);
+
+protected:
+	/**
+	* Spline the character is grinding on.
+	*/
+	UPROPERTY(Transient)
+		USplineComponent* GrindSpline;
+
+	/**
+	* Arc length table of GrindSpline, kept after grinding to be reused on the same spline.
+	*/
+	FDashSplineArcTable GrindArcTable;
+
+	/**
+	* Current distance along GrindSpline.
+	*/
+	float GrindDistance;
+
+	/**
+	* Current signed speed along GrindSpline.
+	*/
+	float GrindSpeed;
+
+public:
+	/**
+	* Lock movement to a path (2.5D); walking and falling physics are constrained each substep to the plane
+	* that contains the path direction and its up vector at the current distance along the path.
+	*
+	* @param Path - Spline to follow.
+	* @return True if the path lock is enabled.
+	*/
+	UFUNCTION(Category = "Pawn|Components|DashCharacterMovement", BlueprintCallable)
+		virtual bool SetPathLock(USplineComponent* Path);
+
+	/**
+	* Unlock movement from the current path and restore previous plane constraint settings.
+	*/
+	UFUNCTION(Category = "Pawn|Components|DashCharacterMovement", BlueprintCallable)
+		virtual void ClearPathLock();
+
+	/**
+	* Return true if movement is locked to a path.
+	*
+	* @return True if a path lock is enabled.
+	*/
+	UFUNCTION(Category = "Pawn|Components|DashCharacterMovement", BlueprintPure)
+		bool IsPathLocked() const;
+
+	/**
+	* Return the current distance along the locked path.
+	*
+	* @return Distance along the path.
+	*/
+	UFUNCTION(Category = "Pawn|Components|DashCharacterMovement", BlueprintPure)
+		float GetPathLockDistance() const;
+
+protected:
+	/**
+	* Update the distance along the locked path and the plane constraint for the next substep;
+	* velocity is turned with the path and the lateral drift is queued for the next move.
+	*/
+	virtual void UpdatePathLock();
+
+protected:
+	/** Move the updated component; adds the pending path lock correction to the constrained delta. */
+	virtual bool MoveUpdatedComponentImpl(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult* OutHit = NULL, ETeleportType Teleport = ETeleportType::None) override;
+
+protected:
+	/**
+	* Path that movement is locked to.
+	*/
+	UPROPERTY(Transient)
+		USplineComponent* PathLockSpline;
+
+	/**
+	* Arc length table of PathLockSpline.
+	*/
+	FDashSplineArcTable PathLockArcTable;
+
+	/**
+	* Current distance along PathLockSpline.
+	*/
+	float PathLockDistance;
+
+	/**
+	* Location of the updated component when PathLockDistance was last updated.
+	*/
+	FVector PathLockLastLocation;
+
+	/**
+	* Lateral offset to the path, applied with the next move.
+	*/
+	FVector PendingPathLockCorrection;
+
+	/**
+	* Plane constraint settings before the path lock.
+	*/
+	uint32 bPathLockSavedConstrainToPlane : 1;
+	FVector PathLockSavedPlaneNormal;
+	EPlaneConstraintAxisSetting PathLockSavedAxisSetting;
+
+public:
+	/** Get prediction data for a client game; allocates Dash saved moves that record gravity state. */
+	virtual class FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+	/** Replay the saved moves after a correction; restores the gravity state the saved moves replaced. */
+	virtual bool ClientUpdatePositionAfterServerUpdate() override;
+
+public:
+	/**
+	* Return the amount of position corrections received from the server since the game started.
+	*
+	* @return Amount of client corrections.
+	*/
+	UFUNCTION(Category = "Pawn|Components|DashCharacterMovement", BlueprintPure)
+		int32 GetNumClientCorrections() const;
+
+protected:
+	/**
+	* Amount of position corrections received from the server.
+	*/
+	int32 NumClientCorrections;
+
+public:
+	/**
+	* Maximum amount of collision queries one tick of this character may issue before a warning is logged; 0 uses p.DashCollisionQueryBudget.
+	*/
+	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		int32 MaxCollisionQueriesPerTick;
+
+public:
+	/**
+	* Return the amount of collision queries issued by a call site during the last tick.
+	*
+	* @param Query - Call site of the queries.
+	* @return Amount of collision queries.
+	*/
+	UFUNCTION(Category = "Pawn|Components|DashCharacterMovement", BlueprintPure)
+		int32 GetNumCollisionQueries(EDashCollisionQuery Query) const;
+
+public:
+	/**
+	* Return the amount of collision queries issued by all call sites during the last tick.
+	*
+	* @return Amount of collision queries.
+	*/
+	UFUNCTION(Category = "Pawn|Components|DashCharacterMovement", BlueprintPure)
+		int32 GetTotalCollisionQueries() const;
+
+protected:
+	/**
+	* Count collision queries issued by a call site during the current tick.
+	*
+	* @param Query - Call site of the queries.
+	* @param Count - Amount of queries.
+	*/
+	void CountCollisionQuery(EDashCollisionQuery Query, int32 Count = 1) const;
+
+protected:
+	/**
+	* Publish the collision query counts of the current tick to stats and the CSV profiler, check them against the budget and start counting the next tick.
+	*/
+	void FlushCollisionQueryCounts();
+
+protected:
+	/**
+	* Collision queries issued during the current tick, per call site; includes the movement manager prepass.
+	*/
+	mutable int32 CollisionQueryCounts[(int32)EDashCollisionQuery::MAX];
+
+protected:
+	/**
+	* Collision queries issued during the last tick, per call site.
+	*/
+	int32 LastCollisionQueryCounts[(int32)EDashCollisionQuery::MAX];
+
+protected:
+	/**
+	* Call site counted for sweeping moves of the updated component.
+	*/
+	EDashCollisionQuery MoveQuery;
+
+protected:
+	/**
+	* World time of the last collision query budget warning.
+	*/
+	float LastCollisionQueryWarningTime;
+
+public:
+	/**
+	* If true, floor checks first trace the collision distance field baked beside the map (see UDashBakeCollisionSDFCommandlet);
+	* static geometry out of reach and flat static floors are answered by the field, and only movable and stationary components
+	* are queried from the physics scene. Near edges, corners, curved surfaces and collision the field couldn't bake,
+	* and on maps without a baked field, the physics scene gives the exact floor.
+	*/
+	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere)
+		uint32 bUseCollisionSDF : 1;
+
+protected:
+	/**
+	* Sweep a capsule down for floor checks, using the collision distance field for static geometry out of reach and flat static floors when available.
+	* Same interface as FloorSweepTest.
+	*/
+	bool CollisionSDFFloorSweepTest(FHitResult& OutHit, const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
+		const FCollisionShape& CollisionShape, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParam) const;
+
+protected:
+	/**
+	* Subsystem holding the collision distance field of the map; null if it isn't used or the map has none.
+	*/
+	UPROPERTY(Transient)
+		UDashCollisionSDFSubsystem* CollisionSDFSubsystem;
+
+public:
+	/**
+	* If true, walking and falling substeps are sized from the speed relative to the capsule radius and from the curvature of the floor,
+	* instead of MaxSimulationTimeStep; MaxSimulationIterations still caps the amount of substeps.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Substepping", BlueprintReadWrite, EditAnywhere)
+		uint32 bUseAdaptiveSubstepping : 1;
+
+	/**
+	* Longest substep when adaptive substepping is used, e.g. on flat straights.
+	* @see bUseAdaptiveSubstepping
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Substepping", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0.0166", ClampMax = "0.50", UIMin = "0.0166", UIMax = "0.50"))
+		float AdaptiveMaxTimeStep;
+
+	/**
+	* Maximum distance covered by a substep, in capsule radii.
+	* @see bUseAdaptiveSubstepping
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Substepping", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0.1", UIMin = "0.1", UIMax = "4"))
+		float AdaptiveMaxStepRadiusRatio;
+
+	/**
+	* Maximum expected change of the floor normal during a substep, in degrees; tighter curves get shorter substeps.
+	* @see bUseAdaptiveSubstepping
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Substepping", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "1", ClampMax = "90", UIMin = "1", UIMax = "45"))
+		float AdaptiveMaxFloorAngle;
+
+public:
+	/**
+	* Return the amount of walking and falling substeps simulated by the last tick.
+	*/
+	UFUNCTION(Category = "Pawn|Components|DashCharacterMovement", BlueprintPure)
+		int32 GetNumSubsteps() const;
+
+protected:
+	/**
+	* Return the time step of the next walking or falling substep; GetSimulationTimeStep when adaptive substepping is disabled.
+	*
+	* @param RemainingTime - Time left to simulate.
+	* @param Iterations - Current iteration of the tick, starting at 1.
+	* @return Time step of the substep.
+	*/
+	float GetAdaptiveSimulationTimeStep(float RemainingTime, int32 Iterations) const;
+
+protected:
+	/**
+	* Measure the curvature of the floor from the change of its normal since the previous substep, and count the substep.
+	*/
+	void UpdateAdaptiveSubstep();
+
+protected:
+	/**
+	* Curvature of the floor along the path, in radians per unit of distance.
+	*/
+	float AdaptiveCurvature;
+
+	/** Floor normal and location of the previous substep; zero normal if there was no walkable floor. */
+	FVector AdaptiveLastFloorNormal;
+	FVector AdaptiveLastLocation;
+
+	/** Amount of substeps of the current and last ticks. */
+	int32 NumSubsteps;
+	int32 LastNumSubsteps;
+
+public:
+	/**
+	* If true, simulated proxies lower their movement detail level with the distance to the local cameras and when they aren't rendered.
+	* @see EDashSimulatedMovementLOD
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Simulated LOD", BlueprintReadWrite, EditAnywhere)
+		uint32 bEnableSimulatedMovementLOD : 1;
+
+	/**
+	* If true, the significance manager rates the character when play begins and chooses its detail level instead of the distance thresholds:
+	* Reduced characters extrapolate, Minimal and Dormant characters interpolate.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Simulated LOD", BlueprintReadWrite, EditAnywhere, meta = (EditCondition = "bEnableSimulatedMovementLOD"))
+		uint32 bUseSignificanceForSimulatedLOD : 1;
+
+	/**
+	* Distance to the closest local camera beyond which simulated proxies extrapolate; scaled by the camera field of view.
+	* Not used with bUseSignificanceForSimulatedLOD.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Simulated LOD", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float SimulatedLODExtrapolateDistance;
+
+	/**
+	* Distance to the closest local camera beyond which simulated proxies interpolate; scaled by the camera field of view.
+	* Not used with bUseSignificanceForSimulatedLOD.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Simulated LOD", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float SimulatedLODInterpolateDistance;
+
+	/**
+	* Simulated proxies that haven't been rendered for this long use the next lower detail level.
+	* Not used with bUseSignificanceForSimulatedLOD, whose ratings already stretch offscreen distances.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Simulated LOD", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float SimulatedLODOffscreenTime;
+
+	/**
+	* Tick interval of extrapolating simulated proxies.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Simulated LOD", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0", UIMax = "0.5"))
+		float SimulatedLODExtrapolateTickInterval;
+
+	/**
+	* Tick interval of interpolating simulated proxies.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Simulated LOD", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0", UIMax = "0.5"))
+		float SimulatedLODInterpolateTickInterval;
+
+	/**
+	* Maximum time extrapolating simulated proxies keep moving without receiving a network update.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Simulated LOD", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0", UIMax = "2"))
+		float SimulatedLODMaxExtrapolationTime;
+
+	/**
+	* How far in the past interpolating simulated proxies are displayed; should cover the time between two network updates.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Simulated LOD", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0", UIMax = "1"))
+		float SimulatedLODInterpolationDelay;
+
+public:
+	/**
+	* Return the current movement detail level; always Full for characters that aren't simulated proxies.
+	*/
+	UFUNCTION(Category = "Pawn|Components|DashCharacterMovement", BlueprintPure)
+		EDashSimulatedMovementLOD GetSimulatedMovementLOD() const;
+
+public:
+	/**
+	* Return the estimated game thread time saved by the movement detail levels of this character since it started, in milliseconds.
+	*/
+	UFUNCTION(Category = "Pawn|Components|DashCharacterMovement", BlueprintPure)
+		float GetSimulatedLODSavedTime() const;
+
+public:
+	/**
+	* Record a replicated location and rotation of a simulated proxy.
+	*
+	* @param Location - Replicated location.
+	* @param Rotation - Replicated rotation.
+	* @return Whether the proxy interpolates between snapshots, in which case the snapshot must not be applied directly.
+	*/
+	bool AddSimulatedSnapshot(const FVector& Location, const FQuat& Rotation);
+
+protected:
+	/**
+	* Choose the movement detail level of a simulated proxy and apply its tick interval.
+	*/
+	void UpdateSimulatedLOD();
+
+protected:
+	/**
+	* Simulate movement at the Extrapolate or Interpolate detail levels.
+	*
+	* @param DeltaSeconds - Time elapsed since the last simulation.
+	*/
+	void SimulateMovementLOD(float DeltaSeconds);
+
+protected:
+	/**
+	* Measure the cost of a tick of a simulated proxy and estimate the time saved by its detail level.
+	*
+	* @param DeltaTime - Time elapsed since the last tick.
+	* @param Cycles - Cost of the tick.
+	*/
+	void RecordSimulatedLODCost(float DeltaTime, uint32 Cycles);
+
+protected:
+	/** Current movement detail level. */
+	EDashSimulatedMovementLOD SimulatedLOD;
+
+	/** Replicated snapshots, oldest first. */
+	TArray<FDashSimulatedSnapshot> SimulatedSnapshots;
+
+	/** Time since the last network update was applied, for extrapolation. */
+	float SimulatedLODTimeSinceUpdate;
+
+	/** Tick interval at the Full detail level. */
+	float SimulatedLODBaseTickInterval;
+
+	/** Estimated time saved since the start, in milliseconds. */
+	float SimulatedLODSavedTime;
+
+	/** Significance manager of the world, with bUseSignificanceForSimulatedLOD; when set, it chooses the detail level instead of the distance thresholds. */
+	UPROPERTY(Transient)
+		UDashSignificanceManager* SignificanceManager;
+
+protected:
+	/**
+	* Drop the cached gravity if the location or gravity settings changed since it was computed.
+	* @return Whether the frame state cache is enabled.
+	*/
+	bool UpdateFrameStateGravityKey() const;
+
+protected:
+	/** Cached gravity and axes of the current substep. */
+	mutable FDashFrameState FrameState;
+
+	/** Amount of gravity and axis queries of the current and last ticks. */
+	mutable int32 NumFrameStateQueries;
+	int32 LastNumFrameStateQueries;
+
+public:
+	/**
+	* If true, rotations requested by UpdateComponentRotation and PhysicsRotation during a movement update are combined and applied once
+	* at its end, inside its scoped movement update; the capsule only sweeps when its up axis changes.
+	* @note Alignment to the floor or gravity then takes effect at the end of the update instead of where it is requested.
+	*/
+	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere)
+		uint32 bDeferRotationUpdates : 1;
+
+protected:
+	/**
+	* Apply the rotation accumulated during the movement update.
+	*/
+	void FlushDeferredRotation();
+
+protected:
+	/** Capsule up axis requested during the movement update. */
+	FVector DeferredAxisZ;
+
+	/** Facing requested during the movement update. */
+	FQuat DeferredRotation;
+
+	/** Whether an up axis or a facing was requested. */
+	uint32 bHasDeferredAxisZ : 1;
+	uint32 bHasDeferredRotation : 1;
+
+public:
+	/**
+	* If true, the capsule collects the rings of the ring subsystem it sweeps through each move.
+	* @see UDashRingSubsystem
+	*/
+	UPROPERTY(Category = "Dash Character Movement", BlueprintReadWrite, EditAnywhere)
+		uint32 bCollectRings : 1;
+
+protected:
+	/**
+	* Collect the rings touched by the capsule during a move.
+	*
+	* @param StartLocation - Location of the capsule at the start of the move.
+	* @param DeltaTime - Duration of the move.
+	*/
+	void CollectRings(const FVector& StartLocation, float DeltaTime);
+
+protected:
+	/** Ring subsystem of the world. */
+	UPROPERTY(Transient)
+		UDashRingSubsystem* RingSubsystem;
+
+public:
+	/**
+	* Time the gravity and axis queries of every Dash character movement component of a world, with and without the frame state cache,
+	* and log the cost of each and the estimated saving per character tick.
+	*
+	* @param World - World to benchmark.
+	* @param Iterations - Amount of times each query is timed.
+	*/
+	static void RunMicroBenchmark(UWorld* World, int32 Iterations);
+
+public:
+	/**
+	* If true, simulated proxies extrapolate along the arc implied by the replicated path, or by gravity while falling,
+	* instead of a straight line. The server only replicates the path with this enabled; pair it with a lower NetUpdateFrequency
+	* of the character to save bandwidth.
+	* @see ReplicatedPath
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Networking", BlueprintReadWrite, EditAnywhere)
+		uint32 bUseCurvedExtrapolation : 1;
+
+	/**
+	* Minimum change of the turn rate of the velocity direction, in degrees per second, to replicate it.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Networking", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0", UIMax = "90"))
+		float PathReplicationTurnRateThreshold;
+
+	/**
+	* Minimum change of the floor normal, in degrees, to replicate it.
+	*/
+	UPROPERTY(Category = "Dash Character Movement|Networking", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", UIMin = "0", UIMax = "45"))
+		float PathReplicationAngleThreshold;
+
+protected:
+	/**
+	* Path shape replicated to simulated proxies.
+	* @see UpdateReplicatedPath
+	*/
+	UPROPERTY(Replicated)
+		FDashReplicatedPath ReplicatedPath;
+
+protected:
+	/**
+	* Copy the current path shape to ReplicatedPath on the server if it changed more than the thresholds.
+	*
+	* @param DeltaSeconds - Time of the last movement update.
+	* @param OldVelocity - Velocity before the last movement update.
+	*/
+	virtual void UpdateReplicatedPath(float DeltaSeconds, const FVector& OldVelocity);
+
+public:
+	/**
+	* Predict the movement of a simulated proxy along the arc implied by the replicated path, or by gravity while falling.
+	*
+	* @param InVelocity - Velocity at the start of the prediction.
+	* @param Time - Duration of the prediction.
+	* @param OutVelocity - Predicted velocity at the end.
+	* @param OutRotationDelta - Rotation of the path over the prediction; identity while falling.
+	* @return Predicted displacement.
+	*/
+	FVector PredictPath(const FVector& InVelocity, float Time, FVector& OutVelocity, FQuat& OutRotationDelta) const;
+
+public:
+	/** Event triggered at the end of a movement update. */
+	virtual void OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity) override;
+};
+
+
+/**
+* Saved move that also records the gravity state that applied to the move, so replayed moves use it.
+*/
+class DASHENGINE_API FSavedMove_DashCharacter : public FSavedMove_Character
+{
+public:
+	typedef FSavedMove_Character Super;
+
+	FSavedMove_DashCharacter();
+
+	/** Custom gravity direction when the move started. */
+	FVector SavedCustomGravityDirection;
+
+	/** Gravity point when the move started. */
+	FVector SavedGravityPoint;
+
+	/** Gravity scale when the move started. */
+	float SavedGravityScale;
+
+	/** Clear saved move properties, so it can be re-used. */
+	virtual void Clear() override;
+
+	/** Set the properties describing the position, etc. of the moved pawn at the start of the move. */
+	virtual void SetInitialPosition(ACharacter* C) override;
+
+	/** Called before ClientUpdatePosition uses this SavedMove to make a predictive correction. */
+	virtual void PrepMoveFor(ACharacter* C) override;
+
+	/** Returns true if this move can be combined with NewMove for replication without changing any behavior; requires the same gravity. */
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+};
+
+
+/**
+* Client prediction data that allocates Dash saved moves.
+*/
+class DASHENGINE_API FNetworkPredictionData_Client_DashCharacter : public FNetworkPredictionData_Client_Character
+{
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	FNetworkPredictionData_Client_DashCharacter(const UCharacterMovementComponent& ClientMovement);
+
+	/** Allocate a new saved move. */
+	virtual FSavedMovePtr AllocateNewMove() override;
 };
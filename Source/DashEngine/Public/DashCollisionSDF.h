@@ -0,0 +1,267 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DashCollisionSDF.generated.h"
+
+class UPrimitiveComponent;
+
+
+/**
+* Component baked into a collision distance field, identified by name so it can be found in any instance of the map.
+*/
+USTRUCT()
+struct FDashCollisionSDFComponent
+{
+	GENERATED_BODY()
+
+	/** Name of the actor that owns the component. */
+	UPROPERTY()
+		FName ActorName;
+
+	/** Name of the component. */
+	UPROPERTY()
+		FName ComponentName;
+};
+
+
+/**
+* Sparse distance field of the static collision of a map, baked offline by the DashBakeCollisionSDF commandlet.
+* Space is split into bricks of BrickSize^3 voxels; only bricks close to collision store samples, others are far from everything.
+* Distances are unsigned and quantized; zero means inside or on collision. Interpolated distances are within GetErrorBound()
+* of the exact distance, except where the closest collision is one flat surface: there the field is linear and GetPlanarHit
+* is exact up to the quantization step. Query the physics scene for exact hits elsewhere.
+* @note Complex-as-simple meshes and landscapes can't be sampled; they aren't baked and the bricks around them are marked instead.
+*/
+UCLASS()
+class DASHENGINE_API UDashCollisionSDF : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UDashCollisionSDF();
+
+public:
+	/**
+	* Return the distance to the closest baked collision.
+	*
+	* @param Location - Location to query, in world space.
+	* @return Distance to collision; at most MaxDistance.
+	*/
+	float GetDistance(const FVector& Location) const;
+
+	/**
+	* Return the direction away from the closest baked collision.
+	*
+	* @param Location - Location to query, in world space.
+	* @return Normalized gradient of the distance field; zero if it is flat.
+	*/
+	FVector GetGradient(const FVector& Location) const;
+
+	/**
+	* Sphere trace the distance field.
+	*
+	* @param Start - Start location of the sphere center.
+	* @param End - End location of the sphere center.
+	* @param Radius - Radius of the sphere.
+	* @param OutTime - Hit time in [0, 1] along the trace.
+	* @param bOutStartPenetrating - Whether the sphere overlaps collision at the start.
+	* @return Whether the sphere hit collision.
+	*/
+	bool SphereTrace(const FVector& Start, const FVector& End, float Radius, float& OutTime, bool& bOutStartPenetrating) const;
+
+	/**
+	* Return the baked component closest to a location, from the samples around it.
+	*
+	* @param Location - Location to query, in world space.
+	* @return Index of the component in Components; INDEX_NONE if the location is far from collision.
+	*/
+	int32 GetComponentIndex(const FVector& Location) const;
+
+	/**
+	* Return the largest difference between an interpolated distance and the exact distance to the baked collision.
+	* Distances are 1-Lipschitz, so trilinear interpolation is off by at most half the voxel diagonal, plus the quantization step.
+	*/
+	float GetErrorBound() const;
+
+	/**
+	* Return the distance and direction to collision at a location whose closest collision is one flat surface.
+	* The field is linear there, so the interpolated distance is exact up to the quantization step.
+	*
+	* @param Location - Location to query, in world space.
+	* @param OutDistance - Distance to the surface.
+	* @param OutNormal - Normal of the surface.
+	* @return Whether the samples around the location are linear; false near edges, corners and curved surfaces, and inside collision.
+	*/
+	bool GetPlanarDistance(const FVector& Location, float& OutDistance, FVector& OutNormal) const;
+
+	/**
+	* Find the exact hit of a sphere with a flat surface, from a time it's known to be clear of collision up to,
+	* e.g. the hit time of the same trace with a sphere inflated by GetErrorBound().
+	*
+	* @param Start - Start location of the sphere center.
+	* @param End - End location of the sphere center.
+	* @param Radius - Radius of the sphere.
+	* @param StartTime - Time in [0, 1] along the trace up to which the sphere is clear of collision.
+	* @param OutTime - Hit time in [0, 1] along the trace.
+	* @param OutNormal - Normal of the surface.
+	* @return Whether the sphere hits one flat surface within a voxel of StartTime; false if the hit can't be computed exactly.
+	*/
+	bool GetPlanarHit(const FVector& Start, const FVector& End, float Radius, float StartTime, float& OutTime, FVector& OutNormal) const;
+
+	/**
+	* Return whether a box is close to static collision that couldn't be baked and is only in the physics scene.
+	*
+	* @param Box - Box to test, in world space.
+	* @return Whether the box touches a brick within MaxDistance of collision that isn't baked.
+	*/
+	bool IsNearUnbakedCollision(const FBox& Box) const;
+
+	/**
+	* Return whether the distance field has been baked.
+	*/
+	bool HasData() const;
+
+#if WITH_EDITOR
+public:
+	/**
+	* Bake the static collision of the persistent level of a world.
+	*
+	* @param World - World to bake; must have its physics scene.
+	* @param InCollisionChannel - Channel the baked components must block.
+	* @param InVoxelSize - Distance between samples.
+	* @param InBrickSize - Amount of voxels along each side of a brick.
+	*/
+	void Build(UWorld* World, ECollisionChannel InCollisionChannel, float InVoxelSize, int32 InBrickSize);
+#endif
+
+protected:
+	/**
+	* Return the index of the brick that contains a location.
+	*
+	* @param VoxelLocation - Location relative to Origin, in voxels.
+	* @param OutBrick - Coordinates of the brick.
+	* @return Index of the brick in BrickTable; INDEX_NONE if the location is outside of the field.
+	*/
+	int32 GetBrickIndex(const FVector& VoxelLocation, FIntVector& OutBrick) const;
+
+public:
+	/** Channel the baked components block; the field only answers queries on this channel. */
+	UPROPERTY(Category = "Collision SDF", VisibleAnywhere)
+		TEnumAsByte<ECollisionChannel> CollisionChannel;
+
+	/** Minimum corner of the field, in world space. */
+	UPROPERTY(Category = "Collision SDF", VisibleAnywhere)
+		FVector Origin;
+
+	/** Distance between samples. */
+	UPROPERTY(Category = "Collision SDF", VisibleAnywhere)
+		float VoxelSize;
+
+	/** Amount of voxels along each side of a brick. */
+	UPROPERTY(Category = "Collision SDF", VisibleAnywhere)
+		int32 BrickSize;
+
+	/** Distance stored by the samples at their maximum quantized value; one brick wide. */
+	UPROPERTY(Category = "Collision SDF", VisibleAnywhere)
+		float MaxDistance;
+
+	/** Amount of bricks along each axis. */
+	UPROPERTY(Category = "Collision SDF", VisibleAnywhere)
+		FIntVector NumBricks;
+
+	/** Baked components. */
+	UPROPERTY(Category = "Collision SDF", VisibleAnywhere)
+		TArray<FDashCollisionSDFComponent> Components;
+
+protected:
+	/** Index of the samples of each brick of the grid; INDEX_NONE for bricks far from collision. */
+	UPROPERTY()
+		TArray<int32> BrickTable;
+
+	/** (BrickSize + 1)^3 quantized distances per stored brick; neighbour bricks share their border samples. */
+	UPROPERTY()
+		TArray<uint16> BrickSamples;
+
+	/** Index of the component closest to each sample of the stored bricks, like BrickSamples; MAX_uint16 for samples far from collision. */
+	UPROPERTY()
+		TArray<uint16> SampleComponents;
+
+	/** Whether each brick of the grid is within MaxDistance of collision that couldn't be baked; empty if all collision is baked. */
+	UPROPERTY()
+		TArray<bool> UnbakedBricks;
+};
+
+
+/**
+* Loads the collision distance field baked beside the map of a world and turns its hits into hit results.
+*/
+UCLASS()
+class DASHENGINE_API UDashCollisionSDFSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	* Load the distance field of the map, once; slow, call it outside of gameplay (e.g. in BeginPlay).
+	*
+	* @return Distance field of the map; null if the map has none.
+	*/
+	UDashCollisionSDF* LoadCollisionSDF();
+
+	/**
+	* Return the loaded distance field.
+	*/
+	FORCEINLINE UDashCollisionSDF* GetCollisionSDF() const
+	{
+		return CollisionSDF;
+	}
+
+public:
+	/**
+	* Sphere trace the distance field of the map; the hit is approximate, see UDashCollisionSDF::GetErrorBound.
+	*
+	* @param OutHit - Hit result, filled like a physics sweep; Location is the sphere center.
+	* @param Start - Start location of the sphere center.
+	* @param End - End location of the sphere center.
+	* @param Radius - Radius of the sphere.
+	* @return Whether the sphere hit collision.
+	*/
+	bool SweepSphere(FHitResult& OutHit, const FVector& Start, const FVector& End, float Radius) const;
+
+	/**
+	* Sweep a sphere onto a flat surface of the distance field of the map; the hit is exact up to the quantization step of the field.
+	*
+	* @param OutHit - Hit result, filled like a physics sweep; Location is the sphere center.
+	* @param Start - Start location of the sphere center.
+	* @param End - End location of the sphere center.
+	* @param Radius - Radius of the sphere.
+	* @param StartTime - Time in [0, 1] along the trace up to which the sphere is clear of collision.
+	* @return Whether the sphere hits a flat surface of a baked component; false if the hit is ambiguous and the physics scene must be queried.
+	*/
+	bool SweepSpherePlanar(FHitResult& OutHit, const FVector& Start, const FVector& End, float Radius, float StartTime) const;
+
+public:
+	/**
+	* Return the path of the distance field asset of a map.
+	*
+	* @param MapPackageName - Long package name of the map.
+	* @return Long package name of the distance field.
+	*/
+	static FString GetCollisionSDFPackageName(const FString& MapPackageName);
+
+protected:
+	/** Distance field of the map. */
+	UPROPERTY(Transient)
+		UDashCollisionSDF* CollisionSDF;
+
+	/** Baked components found in this world, by index. */
+	UPROPERTY(Transient)
+		TArray<UPrimitiveComponent*> Components;
+
+	/** Whether loading the distance field was already attempted. */
+	bool bLoadAttempted;
+};
@@ -0,0 +1,192 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "DashEngineSettings.generated.h"
+
+class UParticleSystem;
+
+
+/**
+* Scalability levels, in the order of the EScalabilityLevel Blueprint enum and of the engine quality levels.
+*/
+UENUM(BlueprintType)
+enum class EDashScalabilityLevel : uint8
+{
+	Low,
+	Medium,
+	High,
+	Epic,
+	Cinematic
+};
+
+
+/**
+* Gameplay significance tiers, from most to least significant.
+*/
+UENUM(BlueprintType)
+enum class EDashSignificance : uint8
+{
+	/** Close or ahead of a viewer; updates at full rate. */
+	Full,
+
+	/** Updates at a reduced rate. */
+	Reduced,
+
+	/** Updates rarely; effects may be dropped. */
+	Minimal,
+
+	/** Far from every viewer; barely updates. */
+	Dormant
+};
+
+
+/**
+* Significance thresholds and rates of a scalability level.
+*/
+USTRUCT()
+struct FDashSignificanceLevel
+{
+	GENERATED_BODY()
+
+	/** Scalability level these settings apply to. */
+	UPROPERTY(Category = "Significance", VisibleAnywhere)
+		EDashScalabilityLevel Level;
+
+	/** Effective distance to the nearest viewer beyond which objects are Reduced. */
+	UPROPERTY(Category = "Significance", EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float ReducedDistance;
+
+	/** Effective distance to the nearest viewer beyond which objects are Minimal. */
+	UPROPERTY(Category = "Significance", EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float MinimalDistance;
+
+	/** Effective distance to the nearest viewer beyond which objects are Dormant. */
+	UPROPERTY(Category = "Significance", EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float DormantDistance;
+
+	/** Minimum tick interval of Reduced objects. */
+	UPROPERTY(Category = "Significance", EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float ReducedTickInterval;
+
+	/** Minimum tick interval of Minimal objects. */
+	UPROPERTY(Category = "Significance", EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float MinimalTickInterval;
+
+	/** Minimum tick interval of Dormant objects. */
+	UPROPERTY(Category = "Significance", EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float DormantTickInterval;
+
+	/** Pooled particle systems spawned at locations of this significance or lower are dropped. */
+	UPROPERTY(Category = "Significance", EditAnywhere)
+		EDashSignificance FXCullSignificance;
+
+	FDashSignificanceLevel()
+		: Level(EDashScalabilityLevel::Low), ReducedDistance(0.0f), MinimalDistance(0.0f), DormantDistance(0.0f),
+		ReducedTickInterval(0.0f), MinimalTickInterval(0.0f), DormantTickInterval(0.0f), FXCullSignificance(EDashSignificance::Dormant)
+	{
+	}
+};
+
+
+/**
+* Amount of actors of a class spawned in the actor pool when a game world starts.
+*/
+USTRUCT()
+struct FDashActorPoolWarmUp
+{
+	GENERATED_BODY()
+
+	/** Class of the actors. */
+	UPROPERTY(Category = "Actor Pool", EditAnywhere)
+		TSoftClassPtr<AActor> ActorClass;
+
+	/** Amount of actors to spawn. */
+	UPROPERTY(Category = "Actor Pool", EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		int32 Count;
+
+	FDashActorPoolWarmUp()
+		: Count(0)
+	{
+	}
+};
+
+
+/**
+* Amount of particle system components of a template created in the FX pool when a game world starts.
+*/
+USTRUCT()
+struct FDashParticlePoolWarmUp
+{
+	GENERATED_BODY()
+
+	/** Particle system of the components. */
+	UPROPERTY(Category = "FX Pool", EditAnywhere)
+		TSoftObjectPtr<UParticleSystem> Template;
+
+	/** Amount of components to create. */
+	UPROPERTY(Category = "FX Pool", EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		int32 Count;
+
+	FDashParticlePoolWarmUp()
+		: Count(0)
+	{
+	}
+};
+
+
+/**
+* Project settings of the Dash engine runtime systems, in DefaultGame.ini.
+*/
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Dash Engine"))
+class DASHENGINE_API UDashEngineSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UDashEngineSettings();
+
+public:
+	/** Actors spawned in the actor pool of each game world when it starts, so spawning them during play doesn't hitch. */
+	UPROPERTY(Category = "Actor Pool", Config, EditAnywhere)
+		TArray<FDashActorPoolWarmUp> ActorPoolWarmUp;
+
+	/** Maximum amount of released actors each class keeps for later; more are destroyed. */
+	UPROPERTY(Category = "Actor Pool", Config, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		int32 MaxPooledActorsPerClass;
+
+	/** Particle system components created in the FX pool of each game world when it starts. */
+	UPROPERTY(Category = "FX Pool", Config, EditAnywhere)
+		TArray<FDashParticlePoolWarmUp> ParticlePoolWarmUp;
+
+	/** Audio components created in the FX pool of each game world when it starts. */
+	UPROPERTY(Category = "FX Pool", Config, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		int32 SoundPoolWarmUp;
+
+	/** Maximum amount of finished components the FX pool keeps per particle template, and for sounds; more are destroyed. */
+	UPROPERTY(Category = "FX Pool", Config, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		int32 MaxPooledFXComponents;
+
+	/** Significance thresholds and rates of each scalability level. */
+	UPROPERTY(Category = "Significance", Config, EditAnywhere, EditFixedSize, meta = (TitleProperty = "Level"))
+		TArray<FDashSignificanceLevel> SignificanceLevels;
+
+	/** Time ahead of a moving viewer that counts as near; at high speed, objects ahead keep detail from further away. */
+	UPROPERTY(Category = "Significance", Config, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float SignificanceLookaheadTime;
+
+	/** Multiplier of the distance of objects behind a moving viewer. */
+	UPROPERTY(Category = "Significance", Config, EditAnywhere, meta = (ClampMin = "1", UIMin = "1"))
+		float SignificanceBehindDistanceScale;
+
+	/** Multiplier of the distance of objects outside of the view of every viewer. */
+	UPROPERTY(Category = "Significance", Config, EditAnywhere, meta = (ClampMin = "1", UIMin = "1"))
+		float SignificanceOffscreenDistanceScale;
+
+public:
+	/**
+	* Return the significance settings of a scalability level; null if none are configured.
+	*/
+	const FDashSignificanceLevel* GetSignificanceLevel(EDashScalabilityLevel Level) const;
+};
@@ -0,0 +1,201 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DashFXPool.generated.h"
+
+class UAudioComponent;
+class UParticleSystem;
+class UParticleSystemComponent;
+class USoundAttenuation;
+class USoundBase;
+class USoundConcurrency;
+
+
+/**
+* Released particle system components of a template.
+*/
+USTRUCT()
+struct FDashParticlePool
+{
+	GENERATED_BODY()
+
+	/** Inactive components, ready to be activated again. */
+	UPROPERTY(Transient)
+		TArray<UParticleSystemComponent*> FreeComponents;
+};
+
+
+/**
+* Pool of particle system and audio components for gameplay FX bursts (ring chains, monitor rows, enemy groups).
+* Components are created and registered when the world starts, released back to the pool when they finish,
+* and the amount of spawns per frame is capped; spawns past the budget are dropped.
+* @note Particle components are kept per template, so a reused component doesn't rebuild its emitters.
+*/
+UCLASS()
+class DASHENGINE_API UDashFXPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Prewarm the pool once the actors of the world are initialized. */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Forget the pooled components; they are destroyed with the world. */
+	virtual void Deinitialize() override;
+
+public:
+	/**
+	* Activate a pooled particle system at a location; it returns to the pool when it finishes.
+	*
+	* @param Template - Particle system to play; must not loop forever.
+	* @param Location - Location of the system.
+	* @param Rotation - Rotation of the system.
+	* @param Scale - Scale of the system.
+	* @return Activated component, only valid until it finishes; null if over budget.
+	*/
+	UParticleSystemComponent* SpawnEmitterAtLocation(UParticleSystem* Template, const FVector& Location, const FRotator& Rotation, const FVector& Scale);
+
+	/**
+	* Play a sound at a location on a pooled audio component; it returns to the pool when it finishes.
+	*
+	* @param Sound - Sound to play; must not loop forever.
+	* @param Location - Location of the sound.
+	* @param Rotation - Rotation of the sound.
+	* @param VolumeMultiplier - Multiplier of the volume of the sound.
+	* @param PitchMultiplier - Multiplier of the pitch of the sound.
+	* @param StartTime - Time in the sound to start at.
+	* @param AttenuationSettings - Attenuation override; null to use the attenuation of the sound.
+	* @param ConcurrencySettings - Concurrency override; null to use the concurrency of the sound.
+	* @return Playing component, only valid until it finishes; null if over budget.
+	*/
+	UAudioComponent* PlaySoundAtLocation(USoundBase* Sound, const FVector& Location, const FRotator& Rotation, float VolumeMultiplier, float PitchMultiplier,
+		float StartTime, USoundAttenuation* AttenuationSettings, USoundConcurrency* ConcurrencySettings);
+
+	/**
+	* Create inactive particle system components of a template until the pool holds a given amount.
+	*
+	* @param Template - Particle system of the components.
+	* @param Count - Amount of inactive components to reach.
+	*/
+	void PrewarmParticles(UParticleSystem* Template, int32 Count);
+
+	/**
+	* Create inactive audio components until the pool holds a given amount.
+	*
+	* @param Count - Amount of inactive components to reach.
+	*/
+	void PrewarmSounds(int32 Count);
+
+protected:
+	/**
+	* Prewarm the pools of the project settings.
+	*/
+	void OnActorsInitialized(const UWorld::FActorsInitializedParams& Params);
+
+	/**
+	* Return whether a spawn fits in the budget of this frame, and count it.
+	*/
+	bool ConsumeBudget(int32& NumSpawned, int32 Budget);
+
+	/**
+	* Return the actor that owns the pooled components, spawning it first if needed.
+	*/
+	AActor* GetPoolActor();
+
+	/**
+	* Create a registered, inactive particle system component.
+	*/
+	UParticleSystemComponent* CreateParticleComponent(UParticleSystem* Template);
+
+	/**
+	* Create a registered, inactive audio component.
+	*/
+	UAudioComponent* CreateAudioComponent();
+
+	/**
+	* Return a finished particle system component to the pool.
+	*/
+	UFUNCTION()
+		void OnParticleFinished(UParticleSystemComponent* Component);
+
+	/**
+	* Return a finished audio component to the pool.
+	*/
+	void OnSoundFinished(UAudioComponent* Component);
+
+protected:
+	/** Inactive particle system components of each template. */
+	UPROPERTY(Transient)
+		TMap<UParticleSystem*, FDashParticlePool> ParticlePools;
+
+	/** Inactive audio components. */
+	UPROPERTY(Transient)
+		TArray<UAudioComponent*> FreeAudioComponents;
+
+	/** Actor owning the pooled components. */
+	UPROPERTY(Transient)
+		AActor* PoolActor;
+
+	/** Maximum amount of inactive components kept per particle template, and of audio components. */
+	int32 MaxFreeComponents;
+
+	/** Frame the spawn counts belong to. */
+	uint64 BudgetFrame;
+
+	/** Amount of particle systems spawned this frame. */
+	int32 NumParticlesSpawned;
+
+	/** Amount of sounds played this frame. */
+	int32 NumSoundsSpawned;
+
+	/** Handle of the actors initialized delegate. */
+	FDelegateHandle ActorsInitializedHandle;
+};
+
+
+/**
+* Blueprint nodes of the FX pool, mirroring the spawn nodes of UGameplayStatics.
+*/
+UCLASS()
+class DASHENGINE_API UDashFXPoolLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	* Play a particle system at a location from the FX pool; like SpawnEmitterAtLocation, without creating a component.
+	*
+	* @param WorldContextObject - Object of the world to play in.
+	* @param EmitterTemplate - Particle system to play; must not loop forever.
+	* @param Location - Location of the system.
+	* @param Rotation - Rotation of the system.
+	* @param Scale - Scale of the system.
+	* @return Activated component, only valid until it finishes; null if over budget.
+	*/
+	UFUNCTION(Category = "Effects|Components|ParticleSystem", BlueprintCallable, meta = (WorldContext = "WorldContextObject", AdvancedDisplay = "Scale", UnsafeDuringActorConstruction = "true", Keywords = "particle system"))
+		static UParticleSystemComponent* SpawnPooledEmitterAtLocation(const UObject* WorldContextObject, UParticleSystem* EmitterTemplate, FVector Location,
+			FRotator Rotation = FRotator::ZeroRotator, FVector Scale = FVector(1.0f));
+
+	/**
+	* Play a sound at a location from the FX pool; like PlaySoundAtLocation, with the spawn budget of the pool.
+	*
+	* @param WorldContextObject - Object of the world to play in.
+	* @param Sound - Sound to play; must not loop forever.
+	* @param Location - Location of the sound.
+	* @param Rotation - Rotation of the sound.
+	* @param VolumeMultiplier - Multiplier of the volume of the sound.
+	* @param PitchMultiplier - Multiplier of the pitch of the sound.
+	* @param StartTime - Time in the sound to start at.
+	* @param AttenuationSettings - Attenuation override; null to use the attenuation of the sound.
+	* @param ConcurrencySettings - Concurrency override; null to use the concurrency of the sound.
+	* @return Playing component, only valid until it finishes; null if over budget.
+	*/
+	UFUNCTION(Category = "Audio", BlueprintCallable, meta = (WorldContext = "WorldContextObject", AdvancedDisplay = "3", UnsafeDuringActorConstruction = "true", Keywords = "play"))
+		static UAudioComponent* PlayPooledSoundAtLocation(const UObject* WorldContextObject, USoundBase* Sound, FVector Location, FRotator Rotation,
+			float VolumeMultiplier = 1.0f, float PitchMultiplier = 1.0f, float StartTime = 0.0f, USoundAttenuation* AttenuationSettings = nullptr,
+			USoundConcurrency* ConcurrencySettings = nullptr);
+};
@@ -0,0 +1,232 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DashGravityField.generated.h"
+
+class USplineComponent;
+
+
+/**
+* Shapes of gravity volumes.
+*/
+UENUM(BlueprintType)
+enum class EDashGravityShape : uint8
+{
+	/** Pulls toward the center of a sphere, e.g. a planet. */
+	Sphere,
+
+	/** Pulls toward the Z axis of a cylinder. */
+	Cylinder,
+
+	/** Pulls along -Z inside a box. */
+	Plane,
+
+	/** Pulls toward the closest point of a spline, inside a tube around it. */
+	SplineTube
+};
+
+
+/**
+* Gravity source placed by designers; baked into the gravity field of the world when it begins play.
+* Dash character movement components inside the volume use its gravity instead of their own
+* custom gravity direction or gravity point, blended across BlendDistance at the boundary.
+* @note Volumes are baked once; call UDashGravityFieldSubsystem::UpdateVolume after moving one.
+*/
+UCLASS(Blueprintable)
+class DASHENGINE_API ADashGravityVolume : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ADashGravityVolume();
+
+public:
+	/** Add the volume to the gravity field. */
+	virtual void BeginPlay() override;
+
+	/** Remove the volume from the gravity field. */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	/**
+	* Return the gravity of the volume at a location.
+	*
+	* @param Location - Location to query, in world space.
+	* @param FirstSegment - First spline segment to search; spline tubes only.
+	* @param NumSegments - Amount of spline segments to search; spline tubes only.
+	* @param OutDirection - Normalized gravity direction, scaled by GravityScale.
+	* @return Influence of the volume, in [0, 1]; zero outside.
+	*/
+	float GetGravityAt(const FVector& Location, int32 FirstSegment, int32 NumSegments, FVector& OutDirection) const;
+
+	/**
+	* Return the world bounds of the volume, including the blend distance.
+	*/
+	FBox GetGravityBounds() const;
+
+	/**
+	* Return the world bounds of a spline segment, including the tube radius and the blend distance.
+	*
+	* @param SegmentIndex - Index of the segment.
+	*/
+	FBox GetSegmentBounds(int32 SegmentIndex) const;
+
+	/**
+	* Return the amount of spline segments the volume bakes separately; zero if it isn't a spline tube.
+	*/
+	int32 GetNumSegments() const;
+
+public:
+	/** Shape of the volume. */
+	UPROPERTY(Category = "Gravity", BlueprintReadOnly, EditAnywhere)
+		EDashGravityShape Shape;
+
+	/** Radius of the sphere, cylinder or tube. */
+	UPROPERTY(Category = "Gravity", BlueprintReadOnly, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float Radius;
+
+	/** Height of the cylinder, along its Z axis. */
+	UPROPERTY(Category = "Gravity", BlueprintReadOnly, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float Height;
+
+	/** Half size of the box of planes. */
+	UPROPERTY(Category = "Gravity", BlueprintReadOnly, EditAnywhere)
+		FVector Extent;
+
+	/** Width of the boundary layer over which the volume fades out. */
+	UPROPERTY(Category = "Gravity", BlueprintReadOnly, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float BlendDistance;
+
+	/** Multiplier of the world gravity magnitude. */
+	UPROPERTY(Category = "Gravity", BlueprintReadOnly, EditAnywhere)
+		float GravityScale;
+
+	/** If true, pushes away from the center, axis or spline instead; e.g. to run on the inside of a tube. */
+	UPROPERTY(Category = "Gravity", BlueprintReadOnly, EditAnywhere)
+		uint32 bInvertDirection : 1;
+
+	/** Overlapping volumes of higher priority are applied first; lower ones only fill what they leave. */
+	UPROPERTY(Category = "Gravity", BlueprintReadOnly, EditAnywhere)
+		int32 Priority;
+
+	/** Center line of spline tubes. */
+	UPROPERTY(Category = "Gravity", BlueprintReadOnly, VisibleAnywhere)
+		USplineComponent* Spline;
+};
+
+
+/**
+* Volume baked into a cell of the gravity field; spline tubes only keep the segments that cross the cell.
+*/
+struct FDashGravityFieldEntry
+{
+	/** Baked volume. */
+	ADashGravityVolume* Volume;
+
+	/** First spline segment crossing the cell. */
+	int32 FirstSegment;
+
+	/** Amount of spline segments crossing the cell. */
+	int32 NumSegments;
+};
+
+
+/**
+* Volume too large to be baked into cells; tested against its bounds on every query instead.
+*/
+struct FDashGravityFieldLargeEntry
+{
+	/** Baked volume. */
+	FDashGravityFieldEntry Entry;
+
+	/** Bounds of the volume or segment. */
+	FBox Bounds;
+};
+
+
+/**
+* Gravity field of a world: gravity volumes baked into a sparse uniform grid,
+* so a location is resolved with one hash lookup and the few volumes of its cell.
+* Volumes covering too many cells are kept aside and tested against their bounds instead.
+*/
+UCLASS()
+class DASHENGINE_API UDashGravityFieldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Read the cell size. */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Release the grid. */
+	virtual void Deinitialize() override;
+
+public:
+	/**
+	* Bake a volume into the grid.
+	*
+	* @param Volume - Volume to add.
+	*/
+	void RegisterVolume(ADashGravityVolume* Volume);
+
+	/**
+	* Remove a volume from the grid.
+	*
+	* @param Volume - Volume to remove.
+	*/
+	void UnregisterVolume(ADashGravityVolume* Volume);
+
+	/**
+	* Bake a volume again after it moved or changed.
+	*
+	* @param Volume - Volume to update.
+	*/
+	UFUNCTION(Category = "Gravity", BlueprintCallable)
+		void UpdateVolume(ADashGravityVolume* Volume);
+
+public:
+	/**
+	* Return the blended gravity of the volumes at a location.
+	*
+	* @param Location - Location to query, in world space.
+	* @param OutGravity - Blended gravity directions scaled by their GravityScale; multiply by the world gravity magnitude.
+	* @return Total influence of the volumes, in [0, 1]; what's left is up to the queried character.
+	*/
+	float GetGravityAt(const FVector& Location, FVector& OutGravity) const;
+
+	/**
+	* Return whether any volume is baked.
+	*/
+	FORCEINLINE bool HasVolumes() const
+	{
+		return Volumes.Num() > 0;
+	}
+
+protected:
+	/**
+	* Return the cell that contains a location.
+	*/
+	FIntVector GetCell(const FVector& Location) const;
+
+	/**
+	* Add an entry to every cell overlapped by a box, or to the large entries if it overlaps too many cells.
+	*/
+	void AddEntry(const FBox& Bounds, const FDashGravityFieldEntry& Entry);
+
+protected:
+	/** Baked volumes. */
+	UPROPERTY(Transient)
+		TArray<ADashGravityVolume*> Volumes;
+
+	/** Entries of each non-empty cell, by decreasing priority. */
+	TMap<FIntVector, TArray<FDashGravityFieldEntry, TInlineAllocator<2>>> Cells;
+
+	/** Entries too large for the cells, by decreasing priority. */
+	TArray<FDashGravityFieldLargeEntry> LargeEntries;
+
+	/** Size of the cells. */
+	float CellSize;
+};
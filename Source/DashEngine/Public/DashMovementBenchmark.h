@@ -0,0 +1,184 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "DashMovementBenchmark.generated.h"
+
+class ADashCharacter;
+class USplineComponent;
+
+
+/**
+* Scripted input of a benchmark character.
+*/
+UENUM()
+enum class EDashBenchmarkScript : uint8
+{
+	/** Run in circles. */
+	Circle,
+
+	/** Run straight ahead; goes through the loops of the test maps. */
+	Run,
+
+	/** Run straight ahead and jump periodically. */
+	Jump,
+
+	/** Grind the splines of actors tagged Rail; runs in circles if the map has none. */
+	Rail,
+
+	MAX UMETA(Hidden)
+};
+
+
+/**
+* Character driven by the benchmark.
+*/
+USTRUCT()
+struct FDashBenchmarkCharacter
+{
+	GENERATED_BODY()
+
+	/** Spawned character. */
+	UPROPERTY(Transient)
+		ADashCharacter* Character;
+
+	/** Scripted input of the character. */
+	EDashBenchmarkScript Script;
+
+	/** Transform the character is reset to. */
+	FTransform SpawnTransform;
+
+	/** Time left before the next jump. */
+	float JumpTime;
+
+	FDashBenchmarkCharacter()
+		: Character(nullptr), Script(EDashBenchmarkScript::Circle), JumpTime(0.0f)
+	{
+	}
+};
+
+
+/**
+* Headless movement benchmark, active only with the -DashBenchmark command line switch.
+* Loads every benchmark map, spawns scripted Dash characters, captures the DashMovement CSV profiler stats
+* (phase timings and sweep counts) and writes a per map summary in Saved/Profiling/DashBenchmark, then quits.
+*
+* Example: UE4Editor DashEngine.uproject -game -nullrhi -unattended -benchmark -fps=60 -DashBenchmark
+*	-BenchmarkMaps=TestMap+2DTestMap+TrickAndRailTest -BenchmarkCharacters=32 -BenchmarkDuration=20
+*/
+UCLASS()
+class DASHENGINE_API UDashMovementBenchmark : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Create the benchmark only when requested on the command line. */
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	/** Parse the benchmark options. */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Stop listening to map loads. */
+	virtual void Deinitialize() override;
+
+public:
+	/** Advance the benchmark. */
+	virtual void Tick(float DeltaTime) override;
+
+	/** The benchmark ticks once initialized. */
+	virtual bool IsTickable() const override;
+
+	/** Stat ID of the benchmark tick. */
+	virtual TStatId GetStatId() const override;
+
+protected:
+	/** Benchmark steps. */
+	enum class EState : uint8
+	{
+		Idle,
+		Loading,
+		WarmingUp,
+		Running,
+		Finished
+	};
+
+protected:
+	/** Open the next benchmark map or finish the benchmark. */
+	void LoadNextMap();
+
+	/** Spawn the benchmark characters once a benchmark map is loaded. */
+	void OnPostLoadMap(UWorld* World);
+
+	/** Spawn the benchmark characters in a world. */
+	void SpawnCharacters(UWorld* World);
+
+	/** Put a character back at its start, spawning it again if it was destroyed (e.g. by the kill Z). */
+	void ResetCharacter(FDashBenchmarkCharacter& BenchmarkCharacter, int32 Index);
+
+	/** Apply the scripted input of every character. */
+	void DriveCharacters(float DeltaTime);
+
+	/** Stop the capture of the current map and record its results. */
+	void FinishMap();
+
+	/** Write the summary of every map and request exit. */
+	void WriteSummary();
+
+protected:
+	/** Maps to benchmark. */
+	TArray<FString> Maps;
+
+	/** Number of characters spawned in each map. */
+	int32 NumCharacters;
+
+	/** Time spent before the capture starts, in seconds. */
+	float WarmupDuration;
+
+	/** Time captured in each map, in seconds. */
+	float Duration;
+
+	/** Time after which the characters go back to their spawn transform, in seconds. */
+	float ResetInterval;
+
+	/** Spawned character class. */
+	UPROPERTY(Transient)
+		TSubclassOf<ADashCharacter> CharacterClass;
+
+	/** Characters of the current map. */
+	UPROPERTY(Transient)
+		TArray<FDashBenchmarkCharacter> Characters;
+
+	/** Rails of the current map. */
+	UPROPERTY(Transient)
+		TArray<USplineComponent*> Rails;
+
+	/** Current step. */
+	EState State;
+
+	/** Index of the current map. */
+	int32 MapIndex;
+
+	/** Time spent in the current step. */
+	float StateTime;
+
+	/** Time since the characters were reset. */
+	float ResetTime;
+
+	/** Number of frames captured in the current map. */
+	int32 NumFrames;
+
+	/** Sum and maximum of the captured game thread times, in milliseconds. */
+	double GameThreadTimeSum;
+	double GameThreadTimeMax;
+
+	/** Start time of the benchmark, used to name the output files. */
+	FString Timestamp;
+
+	/** Summary lines, one per map. */
+	TArray<FString> Results;
+
+	/** Handle of the map load delegate. */
+	FDelegateHandle PostLoadMapHandle;
+};
@@ -0,0 +1,113 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DashMovementManager.generated.h"
+
+class UDashCharacterMovementComponent;
+class UDashMovementManager;
+
+
+/**
+* Tick function of the movement manager; ticks before every registered Dash character movement component.
+*/
+USTRUCT()
+struct FDashMovementManagerTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	/** Manager that owns this tick function. */
+	UDashMovementManager* Manager;
+
+	FDashMovementManagerTickFunction()
+		: Manager(nullptr)
+	{
+	}
+
+	/** Run the movement prepass of the manager. */
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	/** Abbreviated info about this tick function. */
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FDashMovementManagerTickFunction> : public TStructOpsTypeTraitsBase2<FDashMovementManagerTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+
+/**
+* Gathers every Dash character movement component of the world and runs the actor-independent,
+* collision query heavy part of their update (floor prediction) in parallel, before they tick serially.
+* Only components with bUseMovementPrepass run the prepass.
+*/
+UCLASS()
+class DASHENGINE_API UDashMovementManager : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Unregister the tick function. */
+	virtual void Deinitialize() override;
+
+public:
+	/**
+	* Add a movement component to the prepass; the component will tick after the manager.
+	*
+	* @param Component - Component to add.
+	*/
+	void RegisterComponent(UDashCharacterMovementComponent* Component);
+
+	/**
+	* Remove a movement component from the prepass.
+	*
+	* @param Component - Component to remove.
+	*/
+	void UnregisterComponent(UDashCharacterMovementComponent* Component);
+
+	/**
+	* Return the registered movement components.
+	*
+	* @return Registered movement components; may contain components pending destruction.
+	*/
+	FORCEINLINE const TArray<UDashCharacterMovementComponent*>& GetComponents() const
+	{
+		return Components;
+	}
+
+	/**
+	* Return the locations of the characters of the registered movement components.
+	*
+	* @param OutLocations - Locations of the characters; reset first.
+	*/
+	void GetCharacterLocations(TArray<FVector>& OutLocations) const;
+
+public:
+	/**
+	* Run the movement prepass of all registered components.
+	*
+	* @param DeltaTime - Time elapsed since last frame.
+	*/
+	void Tick(float DeltaTime);
+
+protected:
+	/** Registered movement components. */
+	UPROPERTY(Transient)
+		TArray<UDashCharacterMovementComponent*> Components;
+
+	/** Components that run the prepass this frame. */
+	TArray<UDashCharacterMovementComponent*> PrepassComponents;
+
+	/** Time spent by the prepass of each component this frame, in cycles. */
+	TArray<uint64> PrepassCycles;
+
+	/** Tick function that runs the prepass. */
+	FDashMovementManagerTickFunction TickFunction;
+};
@@ -0,0 +1,448 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "GameFramework/Actor.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DashRingSubsystem.generated.h"
+
+class ACharacter;
+class UStaticMesh;
+class UMaterialInterface;
+class USplineComponent;
+class UInstancedStaticMeshComponent;
+class UHierarchicalInstancedStaticMeshComponent;
+class UDashCharacterMovementComponent;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FDashRingsCollectedSignature, ACharacter*, Character, int32, Count);
+
+
+/**
+* Mesh and material shared by rings; rendered by one instanced component.
+*/
+USTRUCT()
+struct FDashRingType
+{
+	GENERATED_BODY()
+
+	/** Ring mesh. */
+	UPROPERTY()
+		UStaticMesh* Mesh;
+
+	/** Material override; null to use the materials of the mesh. */
+	UPROPERTY()
+		UMaterialInterface* Material;
+
+	/** Component rendering every ring of this type. */
+	UPROPERTY()
+		UHierarchicalInstancedStaticMeshComponent* Instances;
+
+	FDashRingType()
+		: Mesh(nullptr), Material(nullptr), Instances(nullptr)
+	{
+	}
+};
+
+
+/**
+* Settings of rings scattered by a character, e.g. when it takes damage.
+* @note Every scattered ring shares one mesh and material; they only change while no scattered ring is left.
+*/
+USTRUCT(BlueprintType)
+struct FDashRingScatterSettings
+{
+	GENERATED_BODY()
+
+	/** Ring mesh; ignored while rings of an earlier scatter are left. */
+	UPROPERTY(Category = "Rings", BlueprintReadWrite, EditAnywhere)
+		UStaticMesh* Mesh;
+
+	/** Material override; null to use the materials of the mesh. Per instance custom data 0 holds the fade, from 1 to 0. Ignored like Mesh. */
+	UPROPERTY(Category = "Rings", BlueprintReadWrite, EditAnywhere)
+		UMaterialInterface* Material;
+
+	/** Horizontal speed of scattered rings. */
+	UPROPERTY(Category = "Rings", BlueprintReadWrite, EditAnywhere)
+		float Speed;
+
+	/** Speed of scattered rings against gravity. */
+	UPROPERTY(Category = "Rings", BlueprintReadWrite, EditAnywhere)
+		float UpSpeed;
+
+	/** Fraction of the speed into a surface kept after bouncing off it. */
+	UPROPERTY(Category = "Rings", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0", ClampMax = "1", UIMin = "0", UIMax = "1"))
+		float Bounciness;
+
+	/** Time scattered rings exist. */
+	UPROPERTY(Category = "Rings", BlueprintReadWrite, EditAnywhere)
+		float Lifetime;
+
+	/** Time scattered rings take to fade at the end of their lifetime. */
+	UPROPERTY(Category = "Rings", BlueprintReadWrite, EditAnywhere)
+		float FadeTime;
+
+	/** Time before scattered rings can be collected. */
+	UPROPERTY(Category = "Rings", BlueprintReadWrite, EditAnywhere)
+		float PickupDelay;
+
+	/** Radius of scattered rings, for collisions and collection. */
+	UPROPERTY(Category = "Rings", BlueprintReadWrite, EditAnywhere)
+		float Radius;
+
+	/** Channel of the traces scattered rings bounce against. */
+	UPROPERTY(Category = "Rings", BlueprintReadWrite, EditAnywhere)
+		TEnumAsByte<ECollisionChannel> CollisionChannel;
+
+	FDashRingScatterSettings()
+		: Mesh(nullptr), Material(nullptr), Speed(600.0f), UpSpeed(700.0f), Bounciness(0.6f), Lifetime(8.0f), FadeTime(2.0f), PickupDelay(0.75f), Radius(30.0f),
+		CollisionChannel(ECC_WorldStatic)
+	{
+	}
+};
+
+
+/**
+* Settings of a scattered ring, kept per slot so later scatters don't change rings already in flight.
+*/
+struct FDashScatteredRingParams
+{
+	/** Time the ring exists. */
+	float Lifetime;
+
+	/** Time the ring takes to fade at the end of its lifetime. */
+	float FadeTime;
+
+	/** Time before the ring can be collected. */
+	float PickupDelay;
+
+	/** Radius of the ring, for collisions and collection. */
+	float Radius;
+
+	/** One plus the bounciness of the ring. */
+	float Restitution;
+
+	/** Channel of the traces the ring bounces against. */
+	TEnumAsByte<ECollisionChannel> CollisionChannel;
+};
+
+
+/**
+* Rings of a world, stored as arrays of their attributes and bucketed in a spatial hash.
+* Rings have no actor or component of their own: they are rendered through one hierarchical instanced mesh per ring type
+* and collected by Dash character movement components with a grid query after they move.
+* Rings scattered by characters live in a fixed pool simulated natively: gravity of the character that scattered them,
+* bounces against a plane refreshed by a few async line traces per frame, a fade and collection through a rebuilt grid.
+* @note Rings don't rotate on their own; spin them in their material (e.g. with RotateAboutAxis on world position offset).
+*/
+UCLASS()
+class DASHENGINE_API UDashRingSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Read the cell size. */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Release the rings. */
+	virtual void Deinitialize() override;
+
+public:
+	/**
+	* Add rings.
+	*
+	* @param Transforms - World transforms of the rings.
+	* @param Mesh - Ring mesh.
+	* @param Material - Material override; null to use the materials of the mesh.
+	* @param Radius - Radius of the rings for collection.
+	* @return Index of the first added ring; the others follow.
+	*/
+	int32 AddRings(const TArray<FTransform>& Transforms, UStaticMesh* Mesh, UMaterialInterface* Material, float Radius);
+
+	/**
+	* Collect the rings touched by a capsule moving in a straight line.
+	*
+	* @param Character - Collecting character, passed to OnRingsCollected.
+	* @param Start - Capsule center at the start of the move.
+	* @param End - Capsule center at the end of the move.
+	* @param Rotation - Capsule rotation.
+	* @param Radius - Capsule radius.
+	* @param HalfHeight - Capsule half height.
+	* @return Amount of collected rings.
+	*/
+	int32 CollectRings(ACharacter* Character, const FVector& Start, const FVector& End, const FQuat& Rotation, float Radius, float HalfHeight);
+
+	/**
+	* Return the amount of rings that weren't collected.
+	*/
+	UFUNCTION(Category = "Rings", BlueprintPure)
+		int32 GetNumActiveRings() const;
+
+	/**
+	* Scatter rings around a character; rings beyond the free slots of the pool aren't scattered.
+	*
+	* @param Source - Movement component of the character; gives the location, gravity and floor of the rings.
+	* @param Count - Amount of rings to scatter.
+	* @param Settings - Settings of these rings; the mesh and material only change while no scattered ring is left.
+	* @return Amount of scattered rings.
+	*/
+	UFUNCTION(Category = "Rings", BlueprintCallable)
+		int32 ScatterRings(UDashCharacterMovementComponent* Source, int32 Count, const FDashRingScatterSettings& Settings);
+
+	/**
+	* Return whether the world has rings left to collect.
+	*/
+	FORCEINLINE bool HasActiveRings() const
+	{
+		return NumActiveRings > 0 || NumScatteredRings > 0;
+	}
+
+public:
+	/** Simulate scattered rings. */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Ticks while rings are scattered. */
+	virtual bool IsTickable() const override;
+
+	/** Ticks with the world of the subsystem. */
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+	/** Stat ID of the tick. */
+	virtual TStatId GetStatId() const override;
+
+public:
+	/** Called on every machine when a character collects rings; check authority before changing gameplay state. */
+	UPROPERTY(Category = "Rings", BlueprintAssignable)
+		FDashRingsCollectedSignature OnRingsCollected;
+
+protected:
+	/**
+	* Return the ring type of a mesh and material, creating its instanced component if needed.
+	*/
+	int32 FindOrAddRingType(UStaticMesh* Mesh, UMaterialInterface* Material);
+
+	/**
+	* Return the cell that contains a location.
+	*/
+	FIntVector GetCell(const FVector& Location) const;
+
+	/**
+	* Build the instance trees of the ring types that received rings since the last build.
+	*/
+	void BuildRenderTrees();
+
+	/**
+	* Create the instances of the pool of scattered rings if needed, and apply the mesh and material of settings if no scattered ring is left.
+	*/
+	void InitScatteredRings(const FDashRingScatterSettings& Settings);
+
+	/**
+	* Collect the scattered rings touched by a capsule; same parameters as CollectRings.
+	*/
+	int32 CollectScatteredRings(const FVector& Start, const FVector& End, const FQuat& Rotation, float Radius, float HalfHeight);
+
+	/**
+	* Return the actor that owns the instances of the rings, spawning it first if needed.
+	*/
+	AActor* GetRenderActor();
+
+	/**
+	* Return the grid bucket of a location, for scattered rings.
+	*/
+	int32 GetScatterBucket(const FVector& Location) const;
+
+	/**
+	* Sort scattered rings into grid buckets after they moved.
+	*/
+	void BuildScatterGrid();
+
+	/**
+	* Update the bounce plane of a scattered ring from an async line trace.
+	*/
+	void OnScatterTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceData);
+
+protected:
+	/** Location of each ring. */
+	TArray<FVector> RingLocations;
+
+	/** Collection radius of each ring. */
+	TArray<float> RingRadii;
+
+	/** Ring type of each ring. */
+	TArray<int32> RingTypeIndices;
+
+	/** Instance of each ring in the component of its type. */
+	TArray<int32> RingInstances;
+
+	/** Whether each ring was collected. */
+	TBitArray<> RingCollected;
+
+	/** Ring types. */
+	UPROPERTY(Transient)
+		TArray<FDashRingType> RingTypes;
+
+	/** Actor owning the instanced components. */
+	UPROPERTY(Transient)
+		AActor* RenderActor;
+
+	/** Rings of each non-empty cell. */
+	TMap<FIntVector, TArray<int32>> Cells;
+
+	/** Size of the cells. */
+	float CellSize;
+
+	/** Largest ring radius, to pad queries. */
+	float MaxRingRadius;
+
+	/** Amount of rings that weren't collected. */
+	int32 NumActiveRings;
+
+	/** Whether a build of the instance trees is scheduled. */
+	bool bRenderTreesPending;
+
+protected:
+	/** Instances of the pool of scattered rings, one per slot; free slots are scaled to zero. */
+	UPROPERTY(Transient)
+		UInstancedStaticMeshComponent* ScatterInstances;
+
+	/** Location, velocity and gravity of each slot. */
+	TArray<FVector> ScatterLocations;
+	TArray<FVector> ScatterVelocities;
+	TArray<FVector> ScatterGravities;
+
+	/** Bounce plane of each slot; a zero normal means no plane. */
+	TArray<FVector> ScatterPlanePoints;
+	TArray<FVector> ScatterPlaneNormals;
+
+	/** Age of each slot. */
+	TArray<float> ScatterAges;
+
+	/** Settings of each slot. */
+	TArray<FDashScatteredRingParams> ScatterParams;
+
+	/** Largest radius of the used slots since the pool was last empty, to pad queries. */
+	float MaxScatterRadius;
+
+	/** Generation of each slot, so trace results of a previous ring are ignored. */
+	TArray<uint16> ScatterGenerations;
+
+	/** Used slots, in no particular order. */
+	TArray<int32> ScatterSlots;
+
+	/** Free slots. */
+	TArray<int32> ScatterFreeSlots;
+
+	/** Instance transforms uploaded each tick. */
+	TArray<FTransform> ScatterTransforms;
+
+	/** First sorted slot of each grid bucket, plus the end. */
+	TArray<int32> ScatterBucketStarts;
+
+	/** Used slots sorted by grid bucket. */
+	TArray<int32> ScatterSortedSlots;
+
+	/** Amount of used slots. */
+	int32 NumScatteredRings;
+
+	/** Next used slot to trace. */
+	int32 NextScatterTrace;
+
+	/** Delegate receiving async trace results; bound once. */
+	FTraceDelegate ScatterTraceDelegate;
+};
+
+
+/**
+* Shapes of ring patterns.
+*/
+UENUM(BlueprintType)
+enum class EDashRingPatternShape : uint8
+{
+	/** One ring at the actor location. */
+	Single,
+
+	/** Rings along the X axis of the actor. */
+	Line,
+
+	/** Rings around a circle in the XY plane of the actor. */
+	Circle,
+
+	/** Rings along an arc in the XZ plane of the actor, going up from its location. */
+	Arc,
+
+	/** Rings along the spline of the actor. */
+	Spline
+};
+
+
+/**
+* Places rings in a pattern; the rings are added to the ring subsystem when play begins and the actor does nothing afterwards.
+* Replaces the RingActor, LinearRings, CircleRings, CurveRings and SplineRings Blueprints with one native actor.
+*/
+UCLASS(Blueprintable)
+class DASHENGINE_API ADashRingPattern : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ADashRingPattern();
+
+public:
+	/** Show the rings in the editor. */
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+	/** Add the rings to the ring subsystem. */
+	virtual void BeginPlay() override;
+
+public:
+	/**
+	* Compute the world transforms of the rings of the pattern.
+	*
+	* @param OutTransforms - Ring transforms.
+	*/
+	virtual void GetRingTransforms(TArray<FTransform>& OutTransforms) const;
+
+public:
+	/** Shape of the pattern. */
+	UPROPERTY(Category = "Rings", BlueprintReadOnly, EditAnywhere)
+		EDashRingPatternShape Shape;
+
+	/** Amount of rings; ignored by single rings. */
+	UPROPERTY(Category = "Rings", BlueprintReadOnly, EditAnywhere, meta = (ClampMin = "1", UIMin = "1", UIMax = "100"))
+		int32 Count;
+
+	/** Distance between rings of lines, and of splines if positive; splines spread Count rings otherwise. */
+	UPROPERTY(Category = "Rings", BlueprintReadOnly, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float Spacing;
+
+	/** Radius of circles and arcs. */
+	UPROPERTY(Category = "Rings", BlueprintReadOnly, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float PatternRadius;
+
+	/** Angle covered by arcs, in degrees. */
+	UPROPERTY(Category = "Rings", BlueprintReadOnly, EditAnywhere, meta = (ClampMin = "0", ClampMax = "360", UIMin = "0", UIMax = "360"))
+		float ArcAngle;
+
+	/** Ring mesh. */
+	UPROPERTY(Category = "Rings", BlueprintReadOnly, EditAnywhere)
+		UStaticMesh* RingMesh;
+
+	/** Material override; null to use the materials of the mesh. */
+	UPROPERTY(Category = "Rings", BlueprintReadOnly, EditAnywhere)
+		UMaterialInterface* RingMaterial;
+
+	/** Radius of the rings for collection. */
+	UPROPERTY(Category = "Rings", BlueprintReadOnly, EditAnywhere, meta = (ClampMin = "0", UIMin = "0"))
+		float RingRadius;
+
+	/** Path of spline patterns. */
+	UPROPERTY(Category = "Rings", BlueprintReadOnly, VisibleAnywhere)
+		USplineComponent* Spline;
+
+#if WITH_EDITORONLY_DATA
+	/** Editor preview of the rings. */
+	UPROPERTY()
+		UInstancedStaticMeshComponent* Preview;
+#endif
+};
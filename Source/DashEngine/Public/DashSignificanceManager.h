@@ -0,0 +1,187 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DashEngineSettings.h"
+#include "DashSignificanceManager.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FDashSignificanceChangedSignature, AActor*, Actor, EDashSignificance, Significance);
+
+
+/**
+* Viewer of the world that significance is measured from.
+*/
+struct FDashSignificanceViewer
+{
+	/** Location of the camera. */
+	FVector Location;
+
+	/** Forward direction of the camera. */
+	FVector Direction;
+
+	/** Direction of movement of the view target; zero if it doesn't move. */
+	FVector MoveDirection;
+
+	/** Distance the view target covers in the lookahead time. */
+	float LookaheadDistance;
+
+	/** Cosine of half the field of view. */
+	float CosHalfFOV;
+};
+
+
+/**
+* Rates gimmicks, enemies and opted-in simulated Dash characters by distance to the local viewers, view and speed-adjusted lookahead,
+* and drives their tick rates, effects and movement detail from one place. Thresholds and rates of each scalability level
+* are in the Dash Engine project settings.
+* @note Ahead of a moving viewer, the lookahead distance counts as near, so at high speed objects keep detail from much further away.
+*/
+UCLASS()
+class DASHENGINE_API UDashSignificanceManager : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Pick the scalability level from the engine quality levels. */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Forget every actor. */
+	virtual void Deinitialize() override;
+
+public:
+	/**
+	* Rate an actor each frame.
+	*
+	* @param Actor - Actor to rate.
+	* @param bApplyTickInterval - Whether the tick intervals of the actor and its components follow its significance.
+	*/
+	UFUNCTION(Category = "Significance", BlueprintCallable)
+		void RegisterActor(AActor* Actor, bool bApplyTickInterval = true);
+
+	/**
+	* Stop rating an actor, restoring its tick intervals.
+	*
+	* @param Actor - Actor to forget.
+	*/
+	UFUNCTION(Category = "Significance", BlueprintCallable)
+		void UnregisterActor(AActor* Actor);
+
+	/**
+	* Return the significance of a registered actor.
+	*
+	* @param Actor - Registered actor.
+	* @param OutSignificance - Significance of the actor this frame.
+	* @return Whether the actor is registered.
+	*/
+	UFUNCTION(Category = "Significance", BlueprintPure)
+		bool GetSignificance(const AActor* Actor, EDashSignificance& OutSignificance) const;
+
+	/**
+	* Rate a location, e.g. the location of an effect.
+	*
+	* @param Location - Location to rate.
+	* @return Significance of the location this frame.
+	*/
+	UFUNCTION(Category = "Significance", BlueprintPure)
+		EDashSignificance RateLocation(const FVector& Location) const;
+
+	/**
+	* Return whether a particle system spawned at a location should be dropped at the current scalability level.
+	*/
+	bool ShouldCullFX(const FVector& Location) const;
+
+public:
+	/**
+	* Set the scalability level gameplay scales with, e.g. from the graphic options menu.
+	*/
+	UFUNCTION(Category = "Significance", BlueprintCallable)
+		void SetScalabilityLevel(EDashScalabilityLevel Level);
+
+	/**
+	* Return the scalability level gameplay scales with.
+	*/
+	UFUNCTION(Category = "Significance", BlueprintPure)
+		EDashScalabilityLevel GetScalabilityLevel() const;
+
+public:
+	/** Rate every registered actor. */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Ticks while actors are registered. */
+	virtual bool IsTickable() const override;
+
+	/** Ticks with the world of the subsystem. */
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+	/** Stat ID of the tick. */
+	virtual TStatId GetStatId() const override;
+
+public:
+	/** Called when the significance of a registered actor changes. */
+	UPROPERTY(Category = "Significance", BlueprintAssignable)
+		FDashSignificanceChangedSignature OnSignificanceChanged;
+
+protected:
+	/**
+	* Copy the settings of the current scalability level.
+	*/
+	void UpdateLevelSettings();
+
+	/**
+	* Gather the cameras and movement of the local players.
+	*/
+	void UpdateViewers();
+
+	/**
+	* Return the distance of a location to the nearest viewer, adjusted for lookahead and view.
+	*/
+	float GetEffectiveDistance(const FVector& Location) const;
+
+	/**
+	* Return the significance of an effective distance.
+	*
+	* @param Distance - Effective distance.
+	* @param Current - Current significance, for hysteresis.
+	*/
+	EDashSignificance GetSignificanceAt(float Distance, EDashSignificance Current) const;
+
+	/**
+	* Remove the actor at an index, moving the last actor into it.
+	*/
+	void RemoveActorAt(int32 Index);
+
+	/**
+	* Apply the tick interval of a significance to an actor and its components; batched Dash actor components get it through the tick manager.
+	*/
+	void ApplyTickInterval(AActor* Actor, EDashSignificance Significance) const;
+
+protected:
+	/** Registered actors. */
+	TArray<TWeakObjectPtr<AActor>> Actors;
+
+	/** Significance of each actor. */
+	TArray<EDashSignificance> Significances;
+
+	/** Whether the tick intervals of each actor follow its significance. */
+	TBitArray<> ApplyTickIntervals;
+
+	/** Index of each actor. */
+	TMap<const AActor*, int32> ActorIndices;
+
+	/** Viewers this frame. */
+	TArray<FDashSignificanceViewer> Viewers;
+
+	/** Settings of the current scalability level. */
+	FDashSignificanceLevel LevelSettings;
+
+	/** Whether settings are configured for the current scalability level. */
+	bool bHasLevelSettings;
+
+	/** Current scalability level. */
+	EDashScalabilityLevel ScalabilityLevel;
+
+	/** Whether the tick intervals must be applied again, after the level changed. */
+	bool bLevelChanged;
+};
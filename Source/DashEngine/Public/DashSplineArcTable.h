@@ -0,0 +1,163 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class USplineComponent;
+
+
+/**
+* Spline frames sampled along the arc length, in local space of the spline component scaled as it was when built.
+* Distances are world arc lengths, so they share units with speeds and velocities even on scaled splines.
+* Queries by distance are a lookup and a lerp instead of the reparameterization of USplineComponent;
+* results are transformed with the current component location and rotation so moving splines are supported.
+* @note Scaling the spline component after building the table isn't supported; build it again.
+*/
+struct DASHENGINE_API FDashSplineArcTable
+{
+public:
+	FDashSplineArcTable();
+
+public:
+	/**
+	* Sample the given spline.
+	*
+	* @param InSpline - Spline to sample.
+	* @param InSampleDistance - Maximum world arc length between two samples.
+	*/
+	void Build(const USplineComponent* InSpline, float InSampleDistance);
+
+	/**
+	* Release sampled data.
+	*/
+	void Reset();
+
+	/**
+	* Return true if the table is built and its spline is still valid.
+	*
+	* @return True if the table can be queried.
+	*/
+	bool IsValid() const;
+
+	/**
+	* Return the sampled spline.
+	*
+	* @return Sampled spline component.
+	*/
+	FORCEINLINE const USplineComponent* GetSpline() const
+	{
+		return Spline.Get();
+	}
+
+	/**
+	* Return the length of the spline.
+	*
+	* @return Arc length of the spline, in world space.
+	*/
+	FORCEINLINE float GetLength() const
+	{
+		return Length;
+	}
+
+	/**
+	* Return true if the spline is a closed loop.
+	*
+	* @return True if the end of the spline joins its start.
+	*/
+	FORCEINLINE bool IsClosedLoop() const
+	{
+		return bClosedLoop;
+	}
+
+public:
+	/**
+	* Wrap a distance on closed loops, clamp it otherwise.
+	*
+	* @param Distance - Distance along the spline.
+	* @return Distance in [0, Length].
+	*/
+	float WrapDistance(float Distance) const;
+
+	/**
+	* Return the world location at a distance along the spline.
+	*
+	* @param Distance - Distance along the spline.
+	* @return World location.
+	*/
+	FVector GetLocationAtDistance(float Distance) const;
+
+	/**
+	* Return the normalized world direction at a distance along the spline.
+	*
+	* @param Distance - Distance along the spline.
+	* @return World direction.
+	*/
+	FVector GetDirectionAtDistance(float Distance) const;
+
+	/**
+	* Return the normalized world up vector at a distance along the spline.
+	*
+	* @param Distance - Distance along the spline.
+	* @return World up vector.
+	*/
+	FVector GetUpVectorAtDistance(float Distance) const;
+
+	/**
+	* Return the normalized world right vector at a distance along the spline.
+	*
+	* @param Distance - Distance along the spline.
+	* @return World right vector.
+	*/
+	FVector GetRightVectorAtDistance(float Distance) const;
+
+	/**
+	* Return the distance along the spline closest to a world location.
+	*
+	* @param WorldLocation - Location to project on the spline.
+	* @param HintDistance - If non-negative, only samples within SearchDistance of this distance are tested.
+	* @param SearchDistance - Arc length searched on both sides of HintDistance.
+	* @return Distance along the spline.
+	*/
+	float FindDistanceClosestToWorldLocation(const FVector& WorldLocation, float HintDistance = -1.0f, float SearchDistance = 500.0f) const;
+
+private:
+	/**
+	* Return the transform of the sampled locations and directions to world space; the scale is already in the samples.
+	*/
+	FTransform GetTransform() const;
+
+	/**
+	* Return the index of the sample segment and the alpha within it for a distance.
+	*/
+	void GetSegment(float Distance, int32& OutIndex, float& OutAlpha) const;
+
+	/**
+	* Return the distance of the point closest to LocalLocation on a segment.
+	*/
+	float GetClosestDistanceOnSegment(int32 Index, const FVector& LocalLocation, float& OutDistanceSquared) const;
+
+private:
+	/** Sampled spline. */
+	TWeakObjectPtr<const USplineComponent> Spline;
+
+	/** Sampled scaled local locations. */
+	TArray<FVector> Locations;
+
+	/** Sampled scaled local directions. */
+	TArray<FVector> Directions;
+
+	/** Sampled scaled local up vectors. */
+	TArray<FVector> UpVectors;
+
+	/** World arc length from the start of the spline to each sample. */
+	TArray<float> Distances;
+
+	/** Shortest world arc length between two samples. */
+	float MinSampleDistance;
+
+	/** Arc length of the spline. */
+	float Length;
+
+	/** If true, the spline is a closed loop. */
+	bool bClosedLoop;
+};
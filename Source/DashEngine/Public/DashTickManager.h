@@ -0,0 +1,146 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DashTickManager.generated.h"
+
+class UDashActorComponent;
+class UDashTickManager;
+
+
+/**
+* Tick function of the tick manager; ticks every batched component.
+*/
+USTRUCT()
+struct FDashTickManagerTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	/** Manager that owns this tick function. */
+	UDashTickManager* Manager;
+
+	FDashTickManagerTickFunction()
+		: Manager(nullptr)
+	{
+	}
+
+	/** Tick the batched components of the manager. */
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	/** Abbreviated info about this tick function. */
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FDashTickManagerTickFunction> : public TStructOpsTypeTraitsBase2<FDashTickManagerTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+
+/**
+* Batched components of a class; they share the tick interval and sleep distance of the class defaults.
+*/
+USTRUCT()
+struct FDashTickBatch
+{
+	GENERATED_BODY()
+
+	/** Class of the components. */
+	UPROPERTY(Transient)
+		UClass* Class;
+
+	/** Components of the class. */
+	UPROPERTY(Transient)
+		TArray<UDashActorComponent*> Components;
+
+	/** Minimum time between two ticks of each component, e.g. from its significance; zero to tick with the batch. */
+	TArray<float> ComponentTickIntervals;
+
+	/** Time elapsed since the last tick of each component with a tick interval. */
+	TArray<float> ComponentTimesSinceTick;
+
+	/** Time between two ticks of the batch; zero to tick every frame. */
+	float TickInterval;
+
+	/** Squared distance to the nearest Dash character beyond which components sleep; zero to never sleep. */
+	float SleepDistanceSquared;
+
+	/** Time elapsed since the last tick of the batch. */
+	float TimeSinceTick;
+
+	FDashTickBatch()
+		: Class(nullptr), TickInterval(0.0f), SleepDistanceSquared(0.0f), TimeSinceTick(0.0f)
+	{
+	}
+};
+
+
+/**
+* Ticks Dash actor components from one tick function instead of one per component,
+* in arrays grouped by class so the same tick code runs back to back.
+* Batches can tick at an interval and skip components far from every Dash character,
+* and components can tick less often than their batch, e.g. when they're less significant.
+*/
+UCLASS()
+class DASHENGINE_API UDashTickManager : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Unregister the tick function. */
+	virtual void Deinitialize() override;
+
+public:
+	/**
+	* Tick a component from its class batch, during physics and not while paused; its own tick function must be disabled.
+	* While the tick of the component is disabled with SetComponentTickEnabled, the batch skips it.
+	*
+	* @param Component - Component to add.
+	* @return Whether the component is batched.
+	*/
+	bool RegisterComponent(UDashActorComponent* Component);
+
+	/**
+	* Stop ticking a component.
+	*
+	* @param Component - Component to remove.
+	*/
+	void UnregisterComponent(UDashActorComponent* Component);
+
+	/**
+	* Set the minimum time between two ticks of a batched component, on top of the interval of its batch.
+	*
+	* @param Component - Batched component.
+	* @param TickInterval - Minimum time between two ticks; zero to tick with the batch.
+	*/
+	void SetComponentTickInterval(UDashActorComponent* Component, float TickInterval);
+
+public:
+	/**
+	* Tick all batches.
+	*
+	* @param DeltaTime - Time elapsed since last frame.
+	* @param TickType - Kind of tick of the world.
+	*/
+	void Tick(float DeltaTime, ELevelTick TickType);
+
+protected:
+	/** Batch of each class. */
+	UPROPERTY(Transient)
+		TArray<FDashTickBatch> Batches;
+
+	/** Locations of the Dash characters this frame. */
+	TArray<FVector> CharacterLocations;
+
+	/** Amount of batched components. */
+	int32 NumComponents;
+
+	/** Tick function that ticks the batches. */
+	FDashTickManagerTickFunction TickFunction;
+};
@@ -0,0 +1,110 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DashUpdateScheduler.generated.h"
+
+DECLARE_DYNAMIC_DELEGATE_OneParam(FDashScheduledUpdate, float, DeltaTime);
+
+
+/**
+* Periodic update registered with the update scheduler.
+*/
+struct FDashScheduledItem
+{
+	/** Handle returned on registration. */
+	int32 Handle;
+
+	/** Actor whose distance to the nearest Dash character sets the priority; the item is removed when it's destroyed. */
+	TWeakObjectPtr<AActor> Owner;
+
+	/** Update to run. */
+	FDashScheduledUpdate Update;
+
+	/** Minimum time between two updates. */
+	float MinInterval;
+
+	/** Time after which the update runs even over the frame budget. */
+	float MaxStaleness;
+
+	/** World time of the last update. */
+	float LastUpdateTime;
+};
+
+
+/**
+* Time-slices non-critical periodic updates (idle animations, rotating monitors, reappearing blocks...) across frames.
+* Each frame, updates run by priority until the frame budget is spent; the priority grows with the time since the
+* last update and shrinks with the distance to the nearest Dash character. Updates receive the time elapsed since
+* their last run, so skipped frames are caught up, and updates starved for MaxStaleness run regardless of the budget.
+*/
+UCLASS()
+class DASHENGINE_API UDashUpdateScheduler : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Reset the handles. */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Remove every update. */
+	virtual void Deinitialize() override;
+
+public:
+	/**
+	* Register a periodic update.
+	*
+	* @param Owner - Actor the update belongs to; its location sets the priority.
+	* @param Update - Update to run, receiving the time elapsed since its last run.
+	* @param MinInterval - Minimum time between two updates; zero to allow updating every frame.
+	* @param MaxStaleness - Time after which the update runs even over the frame budget.
+	* @return Handle of the update.
+	*/
+	UFUNCTION(Category = "Update Scheduler", BlueprintCallable)
+		int32 RegisterUpdate(AActor* Owner, const FDashScheduledUpdate& Update, float MinInterval = 0.0f, float MaxStaleness = 0.5f);
+
+	/**
+	* Remove a periodic update.
+	*
+	* @param Handle - Handle returned by RegisterUpdate.
+	*/
+	UFUNCTION(Category = "Update Scheduler", BlueprintCallable)
+		void UnregisterUpdate(int32 Handle);
+
+	/**
+	* Return the average time since the last update of the registered updates, after this frame's updates.
+	*/
+	UFUNCTION(Category = "Update Scheduler", BlueprintPure)
+		float GetAverageStaleness() const;
+
+public:
+	/** Run the updates of this frame. */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Ticks while updates are registered. */
+	virtual bool IsTickable() const override;
+
+	/** Ticks with the world of the subsystem. */
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+	/** Stat ID of the tick. */
+	virtual TStatId GetStatId() const override;
+
+protected:
+	/** Registered updates. */
+	TArray<FDashScheduledItem> Items;
+
+	/** Priority and index of the updates due this frame, sorted each frame. */
+	TArray<TPair<float, int32>> DueItems;
+
+	/** Locations of the Dash characters this frame. */
+	TArray<FVector> CharacterLocations;
+
+	/** Handle of the next registered update. */
+	int32 NextHandle;
+
+	/** Average time since the last update, after the last tick. */
+	float AverageStaleness;
+};